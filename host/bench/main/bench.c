@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include <inttypes.h>
+#include "bench.h"
+
+#define BENCH_SCHEMA        1
+#define MAX_REPEATS         99
+#define MAX_ITERATIONS      (1ull << 32)
+
+// Heap calls counted while a case runs, see the --wrap options in CMakeLists.txt
+static uint64_t alloc_calls = 0;
+static uint64_t alloc_bytes = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += count * size;
+    return __real_calloc(count, size);
+}
+
+/* Counted as an allocation as well, it may move the block */
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    __real_free(ptr);
+}
+
+// Results are summed here so the compiler cannot drop the operations
+static volatile size_t sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Run iterations operations, return the elapsed ns and the bytes produced
+ */
+static uint64_t run_batch(const bench_case_t *c, uint64_t iterations, uint64_t *bytes)
+{
+    size_t total = 0;
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        total += c->run(c->ctx);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    sink += total;
+    *bytes = total;
+    return elapsed;
+}
+
+/**
+ * @brief Smallest power of two iterations of about a tenth of min_ns, scaled up to min_ns
+ */
+static uint64_t calibrate(const bench_case_t *c, uint64_t min_ns)
+{
+    uint64_t iterations = 1;
+    uint64_t bytes;
+    uint64_t elapsed;
+
+    while ((elapsed = run_batch(c, iterations, &bytes)) < min_ns / 10 && iterations < MAX_ITERATIONS) {
+        iterations *= 2;
+    }
+    if (elapsed < min_ns) {
+        iterations = iterations * min_ns / (elapsed > 0 ? elapsed : 1) + 1;
+    }
+    return iterations < MAX_ITERATIONS ? iterations : MAX_ITERATIONS;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void run_case(const bench_case_t *c, uint64_t min_ns, int repeats, bool last)
+{
+    double ns[MAX_REPEATS];
+    uint64_t bytes = 0;
+    uint64_t iterations = calibrate(c, min_ns);
+
+    alloc_calls = 0;
+    alloc_bytes = 0;
+    for (int r = 0; r < repeats; r++) {
+        ns[r] = (double)run_batch(c, iterations, &bytes) / (double)iterations;
+    }
+    double ops = (double)iterations * repeats;
+    double calls = (double)alloc_calls;
+    double heap_bytes = (double)alloc_bytes;
+
+    qsort(ns, repeats, sizeof(ns[0]), compare_double);
+
+    printf("  {\"name\":\"%s\",\"ns_per_op\":%.1f,\"ns_min\":%.1f,\"iterations\":%" PRIu64 ","
+           "\"bytes_per_op\":%.1f,\"allocs_per_op\":%.2f,\"alloc_bytes_per_op\":%.1f}%s\n",
+           c->name, ns[repeats / 2], ns[0], iterations, (double)bytes / (double)iterations,
+           calls / ops, heap_bytes / ops, last ? "" : ",");
+}
+
+void bench_run(const bench_case_t *cases, size_t count, uint32_t min_time_ms, int repeats)
+{
+    if (repeats < 1) {
+        repeats = 1;
+    } else if (repeats > MAX_REPEATS) {
+        repeats = MAX_REPEATS;
+    }
+
+    printf("{\"schema\":%d,\"min_time_ms\":%" PRIu32 ",\"repeats\":%d,\"results\":[\n", BENCH_SCHEMA,
+           min_time_ms, repeats);
+    for (size_t i = 0; i < count; i++) {
+        run_case(&cases[i], (uint64_t)min_time_ms * 1000000u, repeats, i + 1 == count);
+    }
+    printf("]}\n");
+    fflush(stdout);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One operation of a benchmark case
+ *
+ * @param ctx Case context
+ * @return Bytes produced by the operation (message length, bytes flushed), 0 if none
+ */
+typedef size_t (*bench_fn_t)(void *ctx);
+
+/**
+ * @brief Benchmark case
+ */
+typedef struct {
+    const char *name;       // Stable name, used to match results between runs
+    bench_fn_t run;
+    void *ctx;
+} bench_case_t;
+
+/**
+ * @brief Run all cases and print the results as one JSON document
+ *
+ * The iterations of each case are calibrated so one repeat takes at least
+ * min_time_ms, then the case is timed repeats times. Reported are the
+ * median and minimum ns/op, the bytes per op and the heap allocations
+ * and allocated bytes per op. Cases are printed in the given order, one
+ * per line, so the output diffs cleanly between commits.
+ *
+ * @param cases       Cases to run
+ * @param count       Number of cases
+ * @param min_time_ms Minimum time of one timed repeat
+ * @param repeats     Timed repeats per case
+ */
+void bench_run(const bench_case_t *cases, size_t count, uint32_t min_time_ms, int repeats);
+
+#ifdef __cplusplus
+}
+#endif
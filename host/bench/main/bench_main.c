@@ -0,0 +1,329 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "adc_manager.h"
+#include "adaptive_rate.h"
+#include "sample_history.h"
+#include "display_framebuffer.h"
+#include "trend_plot.h"
+#include "messages/message_formatter.h"
+#include "messages/message_spool.h"
+#include "messages/fixed_point.h"
+#include "virtual_clock.h"
+#include "fake_sensors.h"
+#include "bench.h"
+
+#define MESSAGE_SIZE        192         // Alarm message buffer of the firmware
+#define REPORT_SIZE         1024        // Boot timeline and metrics buffers of the firmware
+#define SPOOL_ARENA_SIZE    4096
+#define BENCH_TASKS         12
+#define BENCH_BOOT_PHASES   9
+
+// Changing input so no case is served from a constant-folded result
+static uint32_t counter = 0;
+
+/* The ADC fake reads the signal at the virtual time, frozen for the benchmarks */
+uint32_t virtual_clock_ms(void)
+{
+    return 0;
+}
+
+static int32_t adc_pin_voltage(uint32_t now_ms)
+{
+    return 1900;
+}
+
+/* 0.01 °C, 21 °C with a 1 °C sawtooth */
+static int32_t temperature(void)
+{
+    return 2100 + (int32_t)(counter++ % 100);
+}
+
+// Message formatting
+
+static size_t bench_format_ds18b20(void *ctx)
+{
+    sensor_sample_t sample = {
+        .id = "28FF641E0F3C0A1B",
+        .sensor = "DS18B20",
+        .period_ms = 10000,
+        .fields = SENSOR_SAMPLE_TEMPERATURE,
+        .temperature = temperature(),
+    };
+    char *json = format_message(&sample);
+    size_t len = json ? strlen(json) : 0;
+    free(json);
+    return len;
+}
+
+static size_t bench_format_dht22(void *ctx)
+{
+    sensor_sample_t sample = {
+        .id = "T01",
+        .sensor = "DHT22",
+        .period_ms = 10000,
+        .fields = SENSOR_SAMPLE_TEMPERATURE | SENSOR_SAMPLE_HUMIDITY,
+        .temperature = temperature(),
+        .humidity = 453,
+    };
+    char *json = format_message(&sample);
+    size_t len = json ? strlen(json) : 0;
+    free(json);
+    return len;
+}
+
+static size_t bench_format_alarm(void *ctx)
+{
+    static uint32_t now_ms = 0;
+    char msg[MESSAGE_SIZE];
+    int32_t value = temperature();
+    now_ms += 1000;
+    int len = format_alarm_message(msg, sizeof(msg), "A0B1C2D3E4F5", "DS18B20", "high", true, value,
+                                   3000, 2, now_ms);
+    return len > 0 ? (size_t)len : 0;
+}
+
+static size_t bench_format_boot_timeline(void *ctx)
+{
+    static const boot_phase_t phases[BENCH_BOOT_PHASES] = {
+        { "nvs", 0, 21, true },
+        { "display", 21, 160, true },
+        { "wifi", 21, 2380, true },
+        { "i2c", 21, 35, true },
+        { "ds18b20", 35, 48, true },
+        { "dht22", 35, 36, true },
+        { "adc", 35, 37, true },
+        { "sntp", 2380, 2911, true },
+        { "mqtt", 2380, 3102, false },
+    };
+    char msg[REPORT_SIZE];
+    int len = format_boot_timeline(msg, sizeof(msg), "A0B1C2D3E4F5", phases, BENCH_BOOT_PHASES, 3102 + counter++ % 8);
+    return len > 0 ? (size_t)len : 0;
+}
+
+static size_t bench_format_metrics(void *ctx)
+{
+    const system_metrics_t *metrics = ctx;
+    char msg[REPORT_SIZE];
+    int len = format_system_metrics(msg, sizeof(msg), "A0B1C2D3E4F5", metrics);
+    return len > 0 ? (size_t)len : 0;
+}
+
+static size_t bench_format_fixed(void *ctx)
+{
+    char text[16];
+    int len = format_fixed(text, sizeof(text), temperature(), 2);
+    return len > 0 ? (size_t)len : 0;
+}
+
+/* What format_fixed replaced, soft-float on the ESP32-C3 */
+static size_t bench_format_float(void *ctx)
+{
+    char text[16];
+    int len = snprintf(text, sizeof(text), "%.2f", temperature() / 100.0f);
+    return len > 0 ? (size_t)len : 0;
+}
+
+// Sampling kernels
+
+static size_t bench_adc_read(void *ctx)
+{
+    int voltage_mv = 0;
+    adc_manager_read_voltage(&voltage_mv);
+    return 0;
+}
+
+static size_t bench_adaptive_rate(void *ctx)
+{
+    static const adaptive_rate_config_t config = {
+        .min_period_ms = 2000,
+        .max_period_ms = 60000,
+        .rate_threshold = 50,
+        .stddev_threshold = 20,
+    };
+    // Own clock, dt_ms stays 10 s across the uint32 wrap
+    static uint32_t now_ms = 0;
+    adaptive_rate_t *state = ctx;
+    now_ms += 10000;
+    adaptive_rate_update(state, &config, temperature(), now_ms);
+    return 0;
+}
+
+/*
+ * One sample per second, a bucket closes every 30 samples. The clock wraps
+ * like the device uptime after 49.7 days, here once per 4.3 million samples.
+ */
+static size_t bench_history_add(void *ctx)
+{
+    static uint32_t now_ms = 0;
+    now_ms += 1000;
+    sample_history_add(HISTORY_DHT22_TEMP, temperature(), now_ms);
+    return 0;
+}
+
+static size_t bench_history_read(void *ctx)
+{
+    history_bucket_t buckets[HISTORY_BUCKETS];
+    uint32_t generation;
+    return sample_history_read(HISTORY_DS18B20_TEMP, buckets, HISTORY_BUCKETS, &generation) * sizeof(buckets[0]);
+}
+
+static size_t bench_spool(void *ctx)
+{
+    message_spool_t *spool = ctx;
+    message_spool_entry_t entry;
+
+    message_spool_push(spool, "test/sensors/temperature",
+                       "{\"id\":\"T01\",\"sensor\":\"DHT22\",\"temperature\":21.43,\"humidity\":45.3}", 1, false);
+    if (!message_spool_peek(spool, &entry)) {
+        return 0;
+    }
+    size_t len = strlen(entry.payload);
+    message_spool_pop(spool);
+    return len;
+}
+
+// Rendering
+
+static size_t bench_draw_string(void *ctx)
+{
+    display_fb_clear();
+    display_fb_draw_string(0, 0, "DS18B20 21.43 C");
+    return 0;
+}
+
+static size_t bench_draw_fixed(void *ctx)
+{
+    display_fb_clear();
+    display_fb_draw_fixed(0, 16, temperature(), 2);
+    return 0;
+}
+
+static size_t bench_draw_label(void *ctx)
+{
+    const display_fb_label_t *label = ctx;
+    display_fb_clear();
+    display_fb_draw_label(0, 32, label);
+    return 0;
+}
+
+/* Alternating series, every frame is a full re-plot */
+static size_t bench_trend_replot(void *ctx)
+{
+    display_fb_clear();
+    trend_plot_draw(counter++ & 1 ? HISTORY_DS18B20_TEMP : HISTORY_VOLTAGE);
+    return 0;
+}
+
+/* Same series and history, plotted columns are reused */
+static size_t bench_trend_unchanged(void *ctx)
+{
+    display_fb_clear();
+    trend_plot_draw(HISTORY_DS18B20_TEMP);
+    return 0;
+}
+
+static esp_err_t count_write(uint8_t page, uint8_t column, const uint8_t *data, size_t len, void *ctx)
+{
+    *(size_t *)ctx += len;
+    return ESP_OK;
+}
+
+static size_t bench_flush_full(void *ctx)
+{
+    size_t bytes = 0;
+    display_fb_invalidate();
+    display_fb_flush(count_write, &bytes);
+    return bytes;
+}
+
+/* Value line changes between frames, only its span is sent */
+static size_t bench_flush_value(void *ctx)
+{
+    size_t bytes = 0;
+    display_fb_draw_fixed(0, 16, temperature(), 2);
+    display_fb_flush(count_write, &bytes);
+    return bytes;
+}
+
+static void fill_metrics(system_metrics_t *metrics)
+{
+    static const char *const names[BENCH_TASKS] = {
+        "main", "IDLE", "tiT", "wifi", "mqtt_task", "sys_evt", "display", "button",
+        "logger", "esp_timer", "ipc0", "Tmr Svc",
+    };
+
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->uptime_s = 86400;
+    metrics->rssi = -61;
+    metrics->heap_internal = (heap_metrics_t){ 182344, 151020, 110592 };
+    metrics->heap_dma = (heap_metrics_t){ 180212, 149876, 110592 };
+    metrics->total_tasks = BENCH_TASKS;
+    metrics->task_count = BENCH_TASKS;
+    for (size_t i = 0; i < BENCH_TASKS; i++) {
+        snprintf(metrics->tasks[i].name, sizeof(metrics->tasks[i].name), "%s", names[i]);
+        metrics->tasks[i].cpu_permille = (uint16_t)(i * 37 % 400);
+        metrics->tasks[i].stack_free = 512 + (uint32_t)i * 96;
+    }
+}
+
+/* Twice the history length of DS18B20 and voltage samples, all buckets filled */
+static void fill_history(void)
+{
+    for (uint32_t t = 0; t < 2 * HISTORY_BUCKETS * HISTORY_BUCKET_MS; t += 5000) {
+        sample_history_add(HISTORY_DS18B20_TEMP, 2100 + (int32_t)(t / 60000 % 300), t);
+        sample_history_add(HISTORY_VOLTAGE, 3800 - (int32_t)(t / 600000), t);
+    }
+}
+
+void app_main(void)
+{
+    static system_metrics_t metrics;
+    static adaptive_rate_t rate;
+    static message_spool_t spool;
+    static uint8_t spool_arena[SPOOL_ARENA_SIZE];
+    static display_fb_label_t label;
+
+    // Only the JSON document goes to stdout
+    esp_log_level_set("*", ESP_LOG_ERROR);
+
+    fake_adc_setup(adc_pin_voltage);
+    ESP_ERROR_CHECK(adc_manager_init());
+
+    fill_metrics(&metrics);
+    fill_history();
+    message_spool_init(&spool, spool_arena, sizeof(spool_arena));
+    display_fb_init();
+    ESP_ERROR_CHECK(display_fb_label_render(&label, "Humidity"));
+
+    const adaptive_rate_config_t rate_config = { 2000, 60000, 50, 20 };
+    adaptive_rate_init(&rate, &rate_config);
+
+    // Names are compared between runs, keep them stable
+    const bench_case_t cases[] = {
+        { "format_message/ds18b20", bench_format_ds18b20, NULL },
+        { "format_message/dht22", bench_format_dht22, NULL },
+        { "format_alarm_message", bench_format_alarm, NULL },
+        { "format_boot_timeline", bench_format_boot_timeline, NULL },
+        { "format_system_metrics", bench_format_metrics, &metrics },
+        { "format_fixed", bench_format_fixed, NULL },
+        { "snprintf_float", bench_format_float, NULL },
+        { "adc/read_voltage", bench_adc_read, NULL },
+        { "adaptive_rate/update", bench_adaptive_rate, &rate },
+        { "sample_history/add", bench_history_add, NULL },
+        { "sample_history/read", bench_history_read, NULL },
+        { "message_spool/push_pop", bench_spool, &spool },
+        { "display/draw_string", bench_draw_string, NULL },
+        { "display/draw_fixed", bench_draw_fixed, NULL },
+        { "display/draw_label", bench_draw_label, &label },
+        { "trend_plot/replot", bench_trend_replot, NULL },
+        { "trend_plot/unchanged", bench_trend_unchanged, NULL },
+        { "display/flush_full", bench_flush_full, NULL },
+        { "display/flush_value", bench_flush_value, NULL },
+    };
+
+    bench_run(cases, sizeof(cases) / sizeof(cases[0]), CONFIG_HOST_BENCH_MIN_TIME_MS, CONFIG_HOST_BENCH_REPEATS);
+    exit(EXIT_SUCCESS);
+}
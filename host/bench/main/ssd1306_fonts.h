@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Stand-in for the font table of the ssd1306 component, which does not
+ * build for the linux target. Rendering cost does not depend on the glyph
+ * shapes, the glyphs are distinct pseudo-random columns so changed text
+ * still changes the frame.
+ */
+static const uint8_t c_chFont1206[95][12] = {
+    { 0x02, 0x10, 0x7F, 0x30, 0xE6, 0xC0, 0x5F, 0x70, 0x5D, 0x40, 0x45, 0x60 },
+    { 0x9B, 0x00, 0x83, 0x60, 0xA9, 0x20, 0x8E, 0x70, 0x2A, 0x00, 0x15, 0x10 },
+    { 0x33, 0x00, 0x87, 0x90, 0x6C, 0x90, 0xBC, 0x60, 0xF7, 0xC0, 0xE5, 0xC0 },
+    { 0xCC, 0xF0, 0x8B, 0xD0, 0x2F, 0x00, 0xEB, 0x50, 0xC3, 0x70, 0xB5, 0x80 },
+    { 0x65, 0xF0, 0x8F, 0x00, 0xF1, 0x70, 0x1A, 0x50, 0x90, 0x30, 0x85, 0x30 },
+    { 0xFE, 0xE0, 0x93, 0x30, 0xB4, 0xE0, 0x49, 0x40, 0x5C, 0xF0, 0x55, 0xE0 },
+    { 0x96, 0xE0, 0x97, 0x60, 0x77, 0x40, 0x77, 0x30, 0x29, 0xA0, 0x25, 0x90 },
+    { 0x2F, 0xD0, 0x9B, 0xA0, 0x3A, 0xB0, 0xA6, 0x30, 0xF5, 0x60, 0xF5, 0x40 },
+    { 0xC8, 0xD0, 0x9F, 0xD0, 0xFC, 0x20, 0xD5, 0x20, 0xC2, 0x20, 0xC5, 0xF0 },
+    { 0x61, 0xC0, 0xA3, 0x00, 0xBF, 0x90, 0x04, 0x10, 0x8E, 0xD0, 0x95, 0xB0 },
+    { 0xF9, 0xC0, 0xA7, 0x30, 0x82, 0xF0, 0x32, 0x00, 0x5B, 0x90, 0x65, 0x60 },
+    { 0x92, 0xB0, 0xAB, 0x70, 0x45, 0x60, 0x61, 0x00, 0x27, 0x50, 0x35, 0x10 },
+    { 0x2B, 0xB0, 0xAF, 0xA0, 0x08, 0xD0, 0x90, 0xF0, 0xF4, 0x10, 0x05, 0xC0 },
+    { 0xC3, 0xA0, 0xB3, 0xD0, 0xCA, 0x40, 0xBF, 0xE0, 0xC1, 0xC0, 0xD5, 0x70 },
+    { 0x5C, 0x90, 0xB7, 0x00, 0x8D, 0xB0, 0xED, 0xE0, 0x8D, 0x80, 0xA5, 0x20 },
+    { 0xF5, 0x90, 0xBB, 0x40, 0x50, 0x10, 0x1C, 0xD0, 0x5A, 0x40, 0x75, 0xD0 },
+    { 0x8E, 0x80, 0xBF, 0x70, 0x13, 0x80, 0x4B, 0xC0, 0x26, 0xF0, 0x45, 0x90 },
+    { 0x26, 0x80, 0xC3, 0xA0, 0xD5, 0xF0, 0x7A, 0xC0, 0xF3, 0xB0, 0x15, 0x40 },
+    { 0xBF, 0x70, 0xC7, 0xD0, 0x98, 0x60, 0xA9, 0xB0, 0xBF, 0x70, 0xE5, 0xF0 },
+    { 0x58, 0x70, 0xCB, 0x10, 0x5B, 0xC0, 0xD7, 0xA0, 0x8C, 0x20, 0xB5, 0xA0 },
+    { 0xF1, 0x60, 0xCF, 0x40, 0x1E, 0x30, 0x06, 0xA0, 0x58, 0xE0, 0x85, 0x50 },
+    { 0x89, 0x60, 0xD3, 0x70, 0xE1, 0xA0, 0x35, 0x90, 0x25, 0xA0, 0x55, 0x00 },
+    { 0x22, 0x50, 0xD7, 0xA0, 0xA3, 0x10, 0x64, 0x80, 0xF2, 0x50, 0x25, 0xC0 },
+    { 0xBB, 0x50, 0xDB, 0xE0, 0x66, 0x80, 0x92, 0x70, 0xBE, 0x10, 0xF5, 0x70 },
+    { 0x54, 0x40, 0xDF, 0x10, 0x29, 0xE0, 0xC1, 0x70, 0x8B, 0xD0, 0xC5, 0x20 },
+    { 0xEC, 0x40, 0xE4, 0x40, 0xEC, 0x50, 0xF0, 0x60, 0x57, 0x90, 0x95, 0xD0 },
+    { 0x85, 0x30, 0xE8, 0x70, 0xAE, 0xC0, 0x1F, 0x50, 0x24, 0x40, 0x65, 0x80 },
+    { 0x1E, 0x20, 0xEC, 0xA0, 0x71, 0x30, 0x4D, 0x50, 0xF0, 0x00, 0x35, 0x30 },
+    { 0xB7, 0x20, 0xF0, 0xE0, 0x34, 0xA0, 0x7C, 0x40, 0xBD, 0xC0, 0x05, 0xE0 },
+    { 0x4F, 0x10, 0xF4, 0x10, 0xF7, 0x00, 0xAB, 0x30, 0x89, 0x70, 0xD5, 0xA0 },
+    { 0xE8, 0x10, 0xF8, 0x40, 0xBA, 0x70, 0xDA, 0x30, 0x56, 0x30, 0xA5, 0x50 },
+    { 0x81, 0x00, 0xFC, 0x70, 0x7C, 0xE0, 0x08, 0x20, 0x23, 0xF0, 0x76, 0x00 },
+    { 0x1A, 0x00, 0x00, 0xB0, 0x3F, 0x50, 0x37, 0x10, 0xEF, 0xA0, 0x46, 0xB0 },
+    { 0xB2, 0xF0, 0x04, 0xE0, 0x02, 0xB0, 0x66, 0x00, 0xBC, 0x60, 0x16, 0x60 },
+    { 0x4B, 0xF0, 0x08, 0x10, 0xC5, 0x20, 0x95, 0x00, 0x88, 0x20, 0xE6, 0x10 },
+    { 0xE4, 0xE0, 0x0C, 0x40, 0x87, 0x90, 0xC4, 0xF0, 0x55, 0xE0, 0xB6, 0xD0 },
+    { 0x7D, 0xE0, 0x10, 0x80, 0x4A, 0x00, 0xF2, 0xE0, 0x21, 0x90, 0x86, 0x80 },
+    { 0x15, 0xD0, 0x14, 0xB0, 0x0D, 0x70, 0x21, 0xE0, 0xEE, 0x50, 0x56, 0x30 },
+    { 0xAE, 0xD0, 0x18, 0xE0, 0xD0, 0xD0, 0x50, 0xD0, 0xBA, 0x10, 0x26, 0xE0 },
+    { 0x47, 0xC0, 0x1C, 0x10, 0x93, 0x40, 0x7F, 0xC0, 0x87, 0xC0, 0xF6, 0x90 },
+    { 0xE0, 0xB0, 0x20, 0x50, 0x55, 0xB0, 0xAD, 0xC0, 0x53, 0x80, 0xC6, 0x40 },
+    { 0x78, 0xB0, 0x24, 0x80, 0x18, 0x20, 0xDC, 0xB0, 0x20, 0x40, 0x96, 0x00 },
+    { 0x11, 0xA0, 0x28, 0xB0, 0xDB, 0x80, 0x0B, 0xA0, 0xED, 0xF0, 0x66, 0xB0 },
+    { 0xAA, 0xA0, 0x2C, 0xE0, 0x9E, 0xF0, 0x3A, 0xA0, 0xB9, 0xB0, 0x36, 0x60 },
+    { 0x43, 0x90, 0x30, 0x20, 0x60, 0x60, 0x68, 0x90, 0x86, 0x70, 0x06, 0x10 },
+    { 0xDB, 0x90, 0x34, 0x50, 0x23, 0xD0, 0x97, 0x80, 0x52, 0x20, 0xD6, 0xC0 },
+    { 0x74, 0x80, 0x38, 0x80, 0xE6, 0x40, 0xC6, 0x70, 0x1F, 0xE0, 0xA6, 0x70 },
+    { 0x0D, 0x80, 0x3C, 0xB0, 0xA9, 0xA0, 0xF5, 0x70, 0xEB, 0xA0, 0x76, 0x20 },
+    { 0xA6, 0x70, 0x40, 0xF0, 0x6C, 0x10, 0x23, 0x60, 0xB8, 0x60, 0x46, 0xE0 },
+    { 0x3E, 0x70, 0x44, 0x20, 0x2E, 0x80, 0x52, 0x50, 0x84, 0x10, 0x16, 0x90 },
+    { 0xD7, 0x60, 0x48, 0x50, 0xF1, 0xF0, 0x81, 0x50, 0x51, 0xD0, 0xE6, 0x40 },
+    { 0x70, 0x60, 0x4C, 0x80, 0xB4, 0x60, 0xB0, 0x40, 0x1E, 0x90, 0xB6, 0xF0 },
+    { 0x08, 0x50, 0x50, 0xC0, 0x77, 0xC0, 0xDF, 0x30, 0xEA, 0x40, 0x86, 0xA0 },
+    { 0xA1, 0x40, 0x54, 0xF0, 0x39, 0x30, 0x0D, 0x30, 0xB7, 0x00, 0x56, 0x50 },
+    { 0x3A, 0x40, 0x58, 0x20, 0xFC, 0xA0, 0x3C, 0x20, 0x83, 0xC0, 0x26, 0x10 },
+    { 0xD3, 0x30, 0x5C, 0x50, 0xBF, 0x10, 0x6B, 0x10, 0x50, 0x70, 0xF6, 0xC0 },
+    { 0x6B, 0x30, 0x60, 0x90, 0x82, 0x70, 0x9A, 0x00, 0x1C, 0x30, 0xC6, 0x70 },
+    { 0x04, 0x20, 0x64, 0xC0, 0x45, 0xE0, 0xC8, 0x00, 0xE9, 0xF0, 0x96, 0x20 },
+    { 0x9D, 0x20, 0x68, 0xF0, 0x07, 0x50, 0xF7, 0xF0, 0xB5, 0xB0, 0x66, 0xD0 },
+    { 0x36, 0x10, 0x6C, 0x20, 0xCA, 0xC0, 0x26, 0xE0, 0x82, 0x60, 0x36, 0x80 },
+    { 0xCE, 0x10, 0x70, 0x60, 0x8D, 0x30, 0x55, 0xE0, 0x4E, 0x20, 0x06, 0x30 },
+    { 0x67, 0x00, 0x74, 0x90, 0x50, 0x90, 0x83, 0xD0, 0x1B, 0xE0, 0xD6, 0xF0 },
+    { 0x00, 0x00, 0x78, 0xC0, 0x12, 0x00, 0xB2, 0xC0, 0xE8, 0x90, 0xA6, 0xA0 },
+    { 0x99, 0xF0, 0x7C, 0xF0, 0xD5, 0x70, 0xE1, 0xC0, 0xB4, 0x50, 0x76, 0x50 },
+    { 0x31, 0xF0, 0x80, 0x20, 0x98, 0xE0, 0x10, 0xB0, 0x81, 0x10, 0x46, 0x00 },
+    { 0xCA, 0xE0, 0x84, 0x60, 0x5B, 0x40, 0x3E, 0xA0, 0x4D, 0xC0, 0x16, 0xB0 },
+    { 0x63, 0xD0, 0x88, 0x90, 0x1E, 0xB0, 0x6D, 0xA0, 0x1A, 0x80, 0xE6, 0x60 },
+    { 0xFC, 0xD0, 0x8D, 0xC0, 0xE0, 0x20, 0x9C, 0x90, 0xE6, 0x40, 0xB6, 0x20 },
+    { 0x94, 0xC0, 0x91, 0xF0, 0xA3, 0x90, 0xCB, 0x80, 0xB3, 0xF0, 0x86, 0xD0 },
+    { 0x2D, 0xC0, 0x95, 0x30, 0x66, 0x00, 0xF9, 0x70, 0x7F, 0xB0, 0x56, 0x80 },
+    { 0xC6, 0xB0, 0x99, 0x60, 0x29, 0x60, 0x28, 0x70, 0x4C, 0x70, 0x26, 0x30 },
+    { 0x5F, 0xB0, 0x9D, 0x90, 0xEB, 0xD0, 0x57, 0x60, 0x19, 0x30, 0xF6, 0xE0 },
+    { 0xF7, 0xA0, 0xA1, 0xC0, 0xAE, 0x40, 0x86, 0x50, 0xE5, 0xE0, 0xC6, 0x90 },
+    { 0x90, 0xA0, 0xA5, 0x00, 0x71, 0xB0, 0xB5, 0x50, 0xB2, 0xA0, 0x96, 0x40 },
+    { 0x29, 0x90, 0xA9, 0x30, 0x34, 0x10, 0xE3, 0x40, 0x7E, 0x60, 0x66, 0x00 },
+    { 0xC2, 0x90, 0xAD, 0x60, 0xF7, 0x80, 0x12, 0x30, 0x4B, 0x10, 0x36, 0xB0 },
+    { 0x5A, 0x80, 0xB1, 0x90, 0xB9, 0xF0, 0x41, 0x30, 0x17, 0xD0, 0x07, 0x60 },
+    { 0xF3, 0x80, 0xB5, 0xD0, 0x7C, 0x60, 0x70, 0x20, 0xE4, 0x90, 0xD7, 0x10 },
+    { 0x8C, 0x70, 0xB9, 0x00, 0x3F, 0xD0, 0x9E, 0x10, 0xB0, 0x40, 0xA7, 0xC0 },
+    { 0x25, 0x60, 0xBD, 0x30, 0x02, 0x30, 0xCD, 0x00, 0x7D, 0x00, 0x77, 0x70 },
+    { 0xBD, 0x60, 0xC1, 0x60, 0xC5, 0xA0, 0xFC, 0x00, 0x49, 0xC0, 0x47, 0x30 },
+    { 0x56, 0x50, 0xC5, 0xA0, 0x87, 0x10, 0x2B, 0xF0, 0x16, 0x70, 0x17, 0xE0 },
+    { 0xEF, 0x50, 0xC9, 0xD0, 0x4A, 0x80, 0x59, 0xE0, 0xE3, 0x30, 0xE7, 0x90 },
+    { 0x88, 0x40, 0xCD, 0x00, 0x0D, 0xF0, 0x88, 0xE0, 0xAF, 0xF0, 0xB7, 0x40 },
+    { 0x20, 0x40, 0xD1, 0x30, 0xD0, 0x50, 0xB7, 0xD0, 0x7C, 0xB0, 0x87, 0xF0 },
+    { 0xB9, 0x30, 0xD5, 0x70, 0x92, 0xC0, 0xE6, 0xC0, 0x48, 0x60, 0x57, 0xA0 },
+    { 0x52, 0x30, 0xD9, 0xA0, 0x55, 0x30, 0x14, 0xC0, 0x15, 0x20, 0x27, 0x50 },
+    { 0xEB, 0x20, 0xDD, 0xD0, 0x18, 0xA0, 0x43, 0xB0, 0xE1, 0xE0, 0xF7, 0x10 },
+    { 0x83, 0x20, 0xE1, 0x00, 0xDB, 0x00, 0x72, 0xA0, 0xAE, 0x90, 0xC7, 0xC0 },
+    { 0x1C, 0x10, 0xE5, 0x40, 0x9E, 0x70, 0xA1, 0xA0, 0x7A, 0x50, 0x97, 0x70 },
+    { 0xB5, 0x10, 0xE9, 0x70, 0x60, 0xE0, 0xD0, 0x90, 0x47, 0x10, 0x67, 0x20 },
+    { 0x4D, 0x00, 0xED, 0xA0, 0x23, 0x50, 0xFE, 0x80, 0x14, 0xC0, 0x37, 0xD0 },
+    { 0xE6, 0xF0, 0xF1, 0xD0, 0xE6, 0xC0, 0x2D, 0x70, 0xE0, 0x80, 0x07, 0x80 },
+    { 0x7F, 0xF0, 0xF5, 0x10, 0xA9, 0x20, 0x5C, 0x70, 0xAD, 0x40, 0xD7, 0x40 },
+    { 0x18, 0xE0, 0xF9, 0x40, 0x6B, 0x90, 0x8B, 0x60, 0x79, 0x00, 0xA7, 0xF0 },
+};
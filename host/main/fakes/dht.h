@@ -0,0 +1,23 @@
+#pragma once
+
+// Subset of the esp-idf-lib/dht API used by dht22_manager
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    DHT_TYPE_DHT11 = 0,
+    DHT_TYPE_AM2301,
+    DHT_TYPE_SI7021,
+} dht_sensor_type_t;
+
+esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin, int16_t *humidity, int16_t *temperature);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+// Subset of the espressif/ds18b20 API used by ds18b20_manager
+
+#include "onewire_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ds18b20_device_t *ds18b20_device_handle_t;
+
+typedef struct {
+    int reserved;
+} ds18b20_config_t;
+
+esp_err_t ds18b20_new_device_from_enumeration(onewire_device_t *device, const ds18b20_config_t *config,
+                                              ds18b20_device_handle_t *ret_ds18b20);
+esp_err_t ds18b20_del_device(ds18b20_device_handle_t ds18b20);
+esp_err_t ds18b20_get_device_address(ds18b20_device_handle_t ds18b20, onewire_device_address_t *ret_address);
+esp_err_t ds18b20_trigger_temperature_conversion(ds18b20_device_handle_t ds18b20);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// Subset of the ESP-IDF ADC calibration API used by adc_manager
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct adc_cali_scheme_t *adc_cali_handle_t;
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage);
+
+#ifdef __cplusplus
+}
+#endif
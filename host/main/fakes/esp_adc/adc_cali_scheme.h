@@ -0,0 +1,27 @@
+#pragma once
+
+// Curve fitting stands in for the chip calibration, it is only available
+// while a replay supplies the captured voltages, see fake_adc_setup_raw()
+
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_oneshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED 1
+
+typedef struct {
+    adc_unit_t unit_id;
+    adc_channel_t chan;
+    adc_atten_t atten;
+    adc_bitwidth_t bitwidth;
+} adc_cali_curve_fitting_config_t;
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t *config,
+                                               adc_cali_handle_t *ret_handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,100 @@
+#include <stdbool.h>
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "virtual_clock.h"
+#include "fake_sensors.h"
+
+#define ADC_VREF_MV     3300
+#define ADC_MAX_RAW     4095
+
+struct adc_oneshot_unit_ctx_t {
+    int channels;
+};
+
+struct adc_cali_scheme_t {
+    int unused;
+};
+
+static struct adc_oneshot_unit_ctx_t fake_unit;
+static struct adc_cali_scheme_t fake_scheme;
+static fake_signal_t voltage_signal = NULL;
+static fake_signal_t calibrated_signal = NULL;
+static bool raw_signal = false;
+
+void fake_adc_setup(fake_signal_t voltage)
+{
+    voltage_signal = voltage;
+    calibrated_signal = NULL;
+    raw_signal = false;
+}
+
+void fake_adc_setup_raw(fake_signal_t raw, fake_signal_t millivolts)
+{
+    voltage_signal = raw;
+    calibrated_signal = millivolts;
+    raw_signal = true;
+}
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *init_config, adc_oneshot_unit_handle_t *ret_unit)
+{
+    *ret_unit = &fake_unit;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel,
+                                     const adc_oneshot_chan_cfg_t *config)
+{
+    handle->channels |= 1 << channel;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw)
+{
+    if (!(handle->channels & (1 << chan))) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (raw_signal) {
+        int32_t raw = voltage_signal(virtual_clock_ms());
+        if (raw == FAKE_SIGNAL_FAIL) {
+            return ESP_FAIL;
+        }
+        *out_raw = raw < 0 ? 0 : raw > ADC_MAX_RAW ? ADC_MAX_RAW : (int)raw;
+        return ESP_OK;
+    }
+
+    int32_t mv = voltage_signal ? voltage_signal(virtual_clock_ms()) : 1650;
+    if (mv < 0) {
+        mv = 0;
+    } else if (mv > ADC_VREF_MV) {
+        mv = ADC_VREF_MV;
+    }
+    *out_raw = (int)((mv * ADC_MAX_RAW + ADC_VREF_MV / 2) / ADC_VREF_MV);
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_del_unit(adc_oneshot_unit_handle_t handle)
+{
+    handle->channels = 0;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t *config,
+                                               adc_cali_handle_t *ret_handle)
+{
+    if (!calibrated_signal) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    *ret_handle = &fake_scheme;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage)
+{
+    if (!calibrated_signal) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    *voltage = (int)calibrated_signal(virtual_clock_ms());
+    return ESP_OK;
+}
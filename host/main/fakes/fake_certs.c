@@ -0,0 +1,12 @@
+#include "cert/cert.h"
+
+/*
+ * Stand-ins for the certificates the firmware build embeds with
+ * EMBED_TXTFILES, the fake client does not use TLS.
+ */
+const uint8_t ca_root_cert_start[] = "";
+const uint8_t ca_root_cert_end[] = "";
+const uint8_t client_cert_start[] = "";
+const uint8_t client_cert_end[] = "";
+const uint8_t client_key_start[] = "";
+const uint8_t client_key_end[] = "";
@@ -0,0 +1,49 @@
+#include "dht.h"
+#include "virtual_clock.h"
+#include "fake_sensors.h"
+
+// Start signal, response and 40 bit transfer of the AM2301
+#define DHT_READ_MS 5
+
+static fake_signal_t temperature_signal = NULL;
+static fake_signal_t humidity_signal = NULL;
+static uint32_t fail_every = 0;
+static uint32_t reads = 0;
+
+void fake_dht_setup(fake_signal_t temperature, fake_signal_t humidity, uint32_t fail_every_n)
+{
+    temperature_signal = temperature;
+    humidity_signal = humidity;
+    fail_every = fail_every_n;
+}
+
+// The DHT22 data pin is the only GPIO configured on the host
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin, int16_t *humidity, int16_t *temperature)
+{
+    virtual_clock_advance(DHT_READ_MS);
+
+    reads++;
+    if (fail_every > 0 && reads % fail_every == 0) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    uint32_t now = virtual_clock_ms();
+    int32_t rh = humidity_signal ? humidity_signal(now) : 450;
+    int32_t t = temperature_signal ? temperature_signal(now) : 250;
+    if (rh == FAKE_SIGNAL_FAIL || t == FAKE_SIGNAL_FAIL) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    if (humidity) {
+        *humidity = (int16_t)rh;
+    }
+    if (temperature) {
+        *temperature = (int16_t)t;
+    }
+    return ESP_OK;
+}
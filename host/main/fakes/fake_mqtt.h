@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief What the fake broker received
+ */
+typedef struct {
+    uint32_t connects;          // MQTT_EVENT_CONNECTED delivered
+    uint32_t published;         // Messages received by the broker
+    uint32_t published_bytes;   // Payload bytes received
+    uint32_t acked;             // QoS 1/2 messages acknowledged
+    uint32_t invalid_json;      // Telemetry payloads that did not parse
+    uint32_t outbox_peak;       // Most bytes waiting for an acknowledge
+} fake_mqtt_stats_t;
+
+/**
+ * @brief Receives every message the broker accepts
+ */
+typedef void (*fake_mqtt_sink_t)(const char *topic, const char *data, int len, void *ctx);
+
+/**
+ * @brief Set the broker timing in virtual ms
+ *
+ * @param connect_ms Delay from client start to MQTT_EVENT_CONNECTED
+ * @param ack_ms     Delay from publish to MQTT_EVENT_PUBLISHED for QoS 1/2
+ */
+void fake_mqtt_setup(uint32_t connect_ms, uint32_t ack_ms);
+
+/**
+ * @brief Deliver the client events due at now_ms, called by the virtual clock
+ */
+void fake_mqtt_run(uint32_t now_ms);
+
+/**
+ * @brief Pass the received messages on, e.g. to compare them against golden output
+ */
+void fake_mqtt_set_sink(fake_mqtt_sink_t sink, void *ctx);
+
+/**
+ * @brief Get the broker counters
+ */
+void fake_mqtt_get_stats(fake_mqtt_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
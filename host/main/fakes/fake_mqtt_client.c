@@ -0,0 +1,184 @@
+#include <stdbool.h>
+#include <string.h>
+#include "esp_log.h"
+#include "cJSON.h"
+#include "mqtt_client.h"
+#include "virtual_clock.h"
+#include "fake_mqtt.h"
+
+static const char *TAG = "fake_mqtt";
+
+#define FAKE_MQTT_MAX_INFLIGHT 64
+#define TELEMETRY_TOPIC_PREFIX "test/sensors/"
+
+typedef struct {
+    int msg_id;
+    int len;
+    uint32_t due_ms;
+} inflight_t;
+
+/* one client talking to an in-process broker, events are delivered by fake_mqtt_run() */
+struct esp_mqtt_client {
+    esp_event_handler_t handler;
+    void *handler_arg;
+    bool started;
+    bool connected;
+    uint32_t connect_due_ms;
+    int next_msg_id;
+    int outbox_bytes;
+    inflight_t inflight[FAKE_MQTT_MAX_INFLIGHT];
+    size_t inflight_head;
+    size_t inflight_count;
+};
+
+static struct esp_mqtt_client fake_client;
+static uint32_t connect_delay_ms = 1000;
+static uint32_t ack_delay_ms = 50;
+static fake_mqtt_stats_t stats;
+static bool running = false;
+static fake_mqtt_sink_t message_sink = NULL;
+static void *message_sink_ctx = NULL;
+
+void fake_mqtt_setup(uint32_t connect_ms, uint32_t ack_ms)
+{
+    connect_delay_ms = connect_ms;
+    ack_delay_ms = ack_ms;
+}
+
+void fake_mqtt_set_sink(fake_mqtt_sink_t sink, void *ctx)
+{
+    message_sink = sink;
+    message_sink_ctx = ctx;
+}
+
+void fake_mqtt_get_stats(fake_mqtt_stats_t *out)
+{
+    *out = stats;
+}
+
+static void deliver(esp_mqtt_event_id_t id, int msg_id)
+{
+    if (fake_client.handler == NULL) {
+        return;
+    }
+    esp_mqtt_event_t event = {
+        .event_id = id,
+        .client = &fake_client,
+        .msg_id = msg_id,
+    };
+    fake_client.handler(fake_client.handler_arg, "MQTT_EVENTS", id, &event);
+}
+
+void fake_mqtt_run(uint32_t now_ms)
+{
+    // Handlers may publish, which never waits, but guard against nesting anyway
+    if (running || !fake_client.started) {
+        return;
+    }
+    running = true;
+
+    if (!fake_client.connected && (int32_t)(now_ms - fake_client.connect_due_ms) >= 0) {
+        fake_client.connected = true;
+        stats.connects++;
+        deliver(MQTT_EVENT_CONNECTED, 0);
+    }
+
+    while (fake_client.inflight_count > 0) {
+        inflight_t *oldest = &fake_client.inflight[fake_client.inflight_head];
+        if ((int32_t)(now_ms - oldest->due_ms) < 0) {
+            break;
+        }
+        int msg_id = oldest->msg_id;
+        fake_client.outbox_bytes -= oldest->len;
+        fake_client.inflight_head = (fake_client.inflight_head + 1) % FAKE_MQTT_MAX_INFLIGHT;
+        fake_client.inflight_count--;
+        stats.acked++;
+        deliver(MQTT_EVENT_PUBLISHED, msg_id);
+    }
+
+    running = false;
+}
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config)
+{
+    memset(&fake_client, 0, sizeof(fake_client));
+    fake_client.next_msg_id = 1;
+    ESP_LOGI(TAG, "Client for %s, protocol %d", config->broker.address.uri, config->session.protocol_ver);
+    return &fake_client;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    if (client->started) {
+        return ESP_FAIL;
+    }
+    client->started = true;
+    client->connect_due_ms = virtual_clock_ms() + connect_delay_ms;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    client->handler = event_handler;
+    client->handler_arg = event_handler_arg;
+    return ESP_OK;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *topic, int qos)
+{
+    return client->connected ? client->next_msg_id++ : -1;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len,
+                            int qos, int retain)
+{
+    if (!client->connected) {
+        return -1;
+    }
+    if (len == 0) {
+        len = (int)strlen(data);
+    }
+
+    stats.published++;
+    stats.published_bytes += (uint32_t)len;
+    if (message_sink != NULL) {
+        message_sink(topic, data, len, message_sink_ctx);
+    }
+
+    // Telemetry must be valid JSON for the subscribers
+    if (strncmp(topic, TELEMETRY_TOPIC_PREFIX, strlen(TELEMETRY_TOPIC_PREFIX)) == 0) {
+        cJSON *json = cJSON_ParseWithLength(data, (size_t)len);
+        if (json == NULL) {
+            stats.invalid_json++;
+            ESP_LOGE(TAG, "Invalid JSON on %s: %.*s", topic, len, data);
+        }
+        cJSON_Delete(json);
+    }
+
+    if (qos == 0) {
+        return 0;
+    }
+    if (client->inflight_count == FAKE_MQTT_MAX_INFLIGHT) {
+        return -1;      // Outbox full
+    }
+
+    int msg_id = client->next_msg_id++;
+    size_t tail = (client->inflight_head + client->inflight_count) % FAKE_MQTT_MAX_INFLIGHT;
+    client->inflight[tail] = (inflight_t) {
+        .msg_id = msg_id,
+        .len = len,
+        .due_ms = virtual_clock_ms() + ack_delay_ms,
+    };
+    client->inflight_count++;
+    client->outbox_bytes += len;
+    if ((uint32_t)client->outbox_bytes > stats.outbox_peak) {
+        stats.outbox_peak = (uint32_t)client->outbox_bytes;
+    }
+    return msg_id;
+}
+
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t client)
+{
+    return client->outbox_bytes;
+}
@@ -0,0 +1,245 @@
+#include <stdbool.h>
+#include <string.h>
+#include "onewire_bus.h"
+#include "onewire_crc.h"
+#include "ds18b20.h"
+#include "virtual_clock.h"
+#include "fake_sensors.h"
+
+// Scripted timing of the bus and the sensor
+#define ONEWIRE_RESET_MS            1       // Reset pulse, presence detect and the following transfer
+#define DS18B20_CONVERSION_MS       750     // 12-bit conversion
+#define DS18B20_POWER_ON_RAW        0x0550  // 85 °C, scratchpad before the first conversion
+
+#define FAKE_MAX_DEVICES            4
+#define DS18B20_FAMILY_CODE         0x28
+#define CMD_MATCH_ROM               0x55
+#define CMD_CONVERT_T               0x44
+#define CMD_READ_SCRATCHPAD         0xBE
+
+struct ds18b20_device_t {
+    onewire_device_address_t address;
+    uint32_t conversion_done_ms;
+    bool converting;
+    bool corrupt;       // Conversion result fails the scratchpad CRC
+    int16_t raw;
+};
+
+struct onewire_device_iter_t {
+    int next;
+};
+
+struct onewire_bus_t {
+    struct ds18b20_device_t *selected;
+    bool read_pending;
+};
+
+static struct onewire_bus_t fake_bus;
+static struct onewire_device_iter_t fake_iter;
+static struct ds18b20_device_t devices[FAKE_MAX_DEVICES];
+static int device_count = 1;
+static fake_signal_t temperature_signal = NULL;
+static bool raw_signal = false;
+
+uint8_t onewire_crc8(uint8_t init_crc, uint8_t *input, size_t input_size)
+{
+    uint8_t crc = init_crc;
+
+    for (size_t i = 0; i < input_size; i++) {
+        uint8_t byte = input[i];
+        for (int bit = 0; bit < 8; bit++) {
+            uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if (mix) {
+                crc ^= 0x8C;
+            }
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
+
+/* ROM code: family code, 48-bit serial, CRC of the first 7 bytes */
+static onewire_device_address_t make_address(int index)
+{
+    uint8_t rom[8] = { DS18B20_FAMILY_CODE, (uint8_t)(0x10 + index), 0x5A, 0xC3, 0x00, 0x00, 0x00 };
+    rom[7] = onewire_crc8(0, rom, 7);
+
+    onewire_device_address_t address = 0;
+    for (int i = 7; i >= 0; i--) {
+        address = (address << 8) | rom[i];
+    }
+    return address;
+}
+
+void fake_ds18b20_setup(int count, fake_signal_t temperature)
+{
+    device_count = count < FAKE_MAX_DEVICES ? count : FAKE_MAX_DEVICES;
+    temperature_signal = temperature;
+    raw_signal = false;
+
+    for (int i = 0; i < FAKE_MAX_DEVICES; i++) {
+        devices[i] = (struct ds18b20_device_t) {
+            .address = make_address(i),
+            .raw = DS18B20_POWER_ON_RAW,
+        };
+    }
+}
+
+void fake_ds18b20_setup_raw(int count, fake_signal_t raw)
+{
+    fake_ds18b20_setup(count, raw);
+    raw_signal = true;
+}
+
+/* latch the conversion result once the conversion time has passed */
+static void update_conversion(struct ds18b20_device_t *device)
+{
+    uint32_t now = virtual_clock_ms();
+
+    if (device->converting && (int32_t)(now - device->conversion_done_ms) >= 0) {
+        int32_t value = temperature_signal ? temperature_signal(device->conversion_done_ms) : 2500;
+        device->corrupt = value == FAKE_SIGNAL_FAIL;
+        if (!device->corrupt) {
+            device->raw = (int16_t)(raw_signal ? value : value * 4 / 25);     // 0.01 °C to 1/16 °C
+        }
+        device->converting = false;
+    }
+}
+
+static void start_conversion(struct ds18b20_device_t *device)
+{
+    update_conversion(device);
+    device->converting = true;
+    device->conversion_done_ms = virtual_clock_ms() + DS18B20_CONVERSION_MS;
+}
+
+esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onewire_bus_rmt_config_t *rmt_config,
+                              onewire_bus_handle_t *ret_bus)
+{
+    if (devices[0].address == 0) {
+        fake_ds18b20_setup(device_count, temperature_signal);
+    }
+    memset(&fake_bus, 0, sizeof(fake_bus));
+    *ret_bus = &fake_bus;
+    return ESP_OK;
+}
+
+esp_err_t onewire_bus_del(onewire_bus_handle_t bus)
+{
+    return ESP_OK;
+}
+
+esp_err_t onewire_bus_reset(onewire_bus_handle_t bus)
+{
+    virtual_clock_advance(ONEWIRE_RESET_MS);
+    bus->selected = NULL;
+    bus->read_pending = false;
+    return device_count > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t onewire_bus_write_bytes(onewire_bus_handle_t bus, const uint8_t *tx_data, uint8_t tx_data_size)
+{
+    if (tx_data_size < 10 || tx_data[0] != CMD_MATCH_ROM) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    onewire_device_address_t address = 0;
+    for (int i = 8; i >= 1; i--) {
+        address = (address << 8) | tx_data[i];
+    }
+
+    for (int i = 0; i < device_count; i++) {
+        if (devices[i].address == address) {
+            bus->selected = &devices[i];
+            bus->read_pending = tx_data[9] == CMD_READ_SCRATCHPAD;
+            if (tx_data[9] == CMD_CONVERT_T) {
+                start_conversion(&devices[i]);
+            }
+            return ESP_OK;
+        }
+    }
+    return ESP_OK;      // Nobody answers, reads return all ones
+}
+
+esp_err_t onewire_bus_read_bytes(onewire_bus_handle_t bus, uint8_t *rx_buf, size_t rx_buf_size)
+{
+    memset(rx_buf, 0xFF, rx_buf_size);
+    if (bus->selected == NULL || !bus->read_pending || rx_buf_size < 9) {
+        return ESP_OK;
+    }
+
+    struct ds18b20_device_t *device = bus->selected;
+    update_conversion(device);
+
+    uint8_t scratchpad[9] = {
+        (uint8_t)device->raw, (uint8_t)((uint16_t)device->raw >> 8),
+        0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10,
+    };
+    scratchpad[8] = onewire_crc8(0, scratchpad, 8);
+    if (device->corrupt) {
+        scratchpad[8] ^= 0xFF;
+    }
+    memcpy(rx_buf, scratchpad, sizeof(scratchpad));
+    bus->read_pending = false;
+    return ESP_OK;
+}
+
+esp_err_t onewire_new_device_iter(onewire_bus_handle_t bus, onewire_device_iter_handle_t *ret_iter)
+{
+    fake_iter.next = 0;
+    *ret_iter = &fake_iter;
+    return ESP_OK;
+}
+
+esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewire_device_t *dev)
+{
+    // One search pass per device
+    virtual_clock_advance(ONEWIRE_RESET_MS);
+    if (iter->next >= device_count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    dev->bus = &fake_bus;
+    dev->address = devices[iter->next++].address;
+    return ESP_OK;
+}
+
+esp_err_t onewire_del_device_iter(onewire_device_iter_handle_t iter)
+{
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_new_device_from_enumeration(onewire_device_t *device, const ds18b20_config_t *config,
+                                              ds18b20_device_handle_t *ret_ds18b20)
+{
+    if ((device->address & 0xFF) != DS18B20_FAMILY_CODE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    for (int i = 0; i < device_count; i++) {
+        if (devices[i].address == device->address) {
+            *ret_ds18b20 = &devices[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t ds18b20_del_device(ds18b20_device_handle_t ds18b20)
+{
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_get_device_address(ds18b20_device_handle_t ds18b20, onewire_device_address_t *ret_address)
+{
+    *ret_address = ds18b20->address;
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_trigger_temperature_conversion(ds18b20_device_handle_t ds18b20)
+{
+    // Reset, match ROM and CONVERT T, then the wait of the component
+    virtual_clock_advance(ONEWIRE_RESET_MS);
+    start_conversion(ds18b20);
+    virtual_clock_advance(DS18B20_CONVERSION_MS);
+    return ESP_OK;
+}
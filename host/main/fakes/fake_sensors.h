@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Scripted sensor value as a function of the virtual time
+ */
+typedef int32_t (*fake_signal_t)(uint32_t now_ms);
+
+/**
+ * @brief Signal value that makes the read fail, as a bus or checksum error would
+ */
+#define FAKE_SIGNAL_FAIL INT32_MIN
+
+/**
+ * @brief Set the DS18B20 devices found on the 1-wire bus
+ *
+ * @param count       Number of devices (0-4)
+ * @param temperature Temperature in 0.01 °C, resolved to 1/16 °C as by the sensor
+ */
+void fake_ds18b20_setup(int count, fake_signal_t temperature);
+
+/**
+ * @brief Set the DS18B20 devices with the scratchpad value itself, e.g. replayed from a capture
+ *
+ * @param count Number of devices (0-4)
+ * @param raw   Scratchpad temperature in 1/16 °C, FAKE_SIGNAL_FAIL corrupts the scratchpad CRC
+ */
+void fake_ds18b20_setup_raw(int count, fake_signal_t raw);
+
+/**
+ * @brief Set the DHT22 values
+ *
+ * @param temperature Temperature in 0.1 °C, FAKE_SIGNAL_FAIL fails the read
+ * @param humidity    Humidity in 0.1 %RH, FAKE_SIGNAL_FAIL fails the read
+ * @param fail_every  Every N-th read fails with a checksum error, 0 = never
+ */
+void fake_dht_setup(fake_signal_t temperature, fake_signal_t humidity, uint32_t fail_every);
+
+/**
+ * @brief Set the voltage at the ADC pin in mV, 12-bit quantized on read
+ */
+void fake_adc_setup(fake_signal_t voltage);
+
+/**
+ * @brief Set the ADC code itself (0-4095), e.g. replayed from a capture, FAKE_SIGNAL_FAIL fails the read
+ *
+ * With millivolts set, calibration is reported as available and converts
+ * every read to that voltage instead of the linear host conversion.
+ *
+ * @param raw        ADC code
+ * @param millivolts Calibrated pin voltage in mV, NULL for no calibration
+ */
+void fake_adc_setup_raw(fake_signal_t raw, fake_signal_t millivolts);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,10 @@
+#include "sleep_manager.h"
+
+/*
+ * alarm_manager keeps its state across deep sleep wakes, the host always
+ * starts cold. sleep_manager.c itself is not built, it needs esp_sleep.
+ */
+bool sleep_manager_is_wake(void)
+{
+    return false;
+}
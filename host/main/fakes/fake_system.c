@@ -0,0 +1,10 @@
+#include "esp_system.h"
+
+/*
+ * ds18b20_manager skips the bus search after a deep sleep wake, the host
+ * always starts cold. Weak, in case the linux port of esp_system provides it.
+ */
+__attribute__((weak)) esp_reset_reason_t esp_reset_reason(void)
+{
+    return ESP_RST_POWERON;
+}
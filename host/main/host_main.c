@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_event.h"
+#include "sdkconfig.h"
+#include "ds18b20_manager.h"
+#include "dht22_manager.h"
+#include "sht3x_manager.h"
+#include "bme280_manager.h"
+#include "i2c_bus_manager.h"
+#include "adc_manager.h"
+#include "mqtt_manager.h"
+#include "alarm_manager.h"
+#include "sampling_scheduler.h"
+#include "sample_pipeline.h"
+#include "virtual_clock.h"
+#include "fake_sensors.h"
+#include "fake_mqtt.h"
+#include "replay.h"
+
+static const char *TAG = "host";
+
+#define MAX_IDLE_WAIT_MS    1000        // As in the firmware main loop
+#define FLUSH_TIMEOUT_MS    10000
+#define HOUR_MS             3600000u
+
+// Heat spike on the DS18B20 in the middle of the run, raises and clears the alarms
+#define SPIKE_START_MS      (CONFIG_HOST_RUN_HOURS * HOUR_MS / 2)
+#define SPIKE_LENGTH_MS     (10 * 60 * 1000)
+
+// A replay ends when every captured read was taken, this bounds a capture the schedule never drains
+#define REPLAY_LIMIT_MS     (720 * HOUR_MS)
+
+static uint32_t alarms_raised = 0;
+static uint32_t alarms_cleared = 0;
+
+/* triangle wave between -amplitude and +amplitude */
+static int32_t triangle(uint32_t now_ms, uint32_t period_ms, int32_t amplitude)
+{
+    uint32_t half = period_ms / 2;
+    uint32_t phase = now_ms % period_ms;
+    uint32_t ramp = phase < half ? phase : period_ms - phase;
+    return (int32_t)((int64_t)ramp * 2 * amplitude / half) - amplitude;
+}
+
+/* 0.01 °C, 21 °C ± 3 °C over 6 h */
+static int32_t ds18b20_temperature(uint32_t now_ms)
+{
+    if (now_ms - SPIKE_START_MS < SPIKE_LENGTH_MS) {
+        return 6500;
+    }
+    return 2100 + triangle(now_ms, 6 * HOUR_MS, 300);
+}
+
+/* 0.1 °C, 22 °C ± 2 °C over 4 h */
+static int32_t dht22_temperature(uint32_t now_ms)
+{
+    return 220 + triangle(now_ms, 4 * HOUR_MS, 20);
+}
+
+/* 0.1 %RH, 45 % ± 10 % over 3 h */
+static int32_t dht22_humidity(uint32_t now_ms)
+{
+    return 450 + triangle(now_ms, 3 * HOUR_MS, 100);
+}
+
+/* mV at the ADC pin, half the battery voltage, 1.9 V falling 1 mV per 10 minutes */
+static int32_t battery_voltage(uint32_t now_ms)
+{
+    return 1900 - (int32_t)(now_ms / 600000);
+}
+
+static void alarm_event_handler(const alarm_event_t *event)
+{
+    if (event->active) {
+        alarms_raised++;
+    } else {
+        alarms_cleared++;
+    }
+    ESP_LOGI(TAG, "%" PRIu32 " ms: %s alarm %s on %s, value %" PRId32, event->timestamp_ms,
+             alarm_manager_rule_name(event->rule->type), event->active ? "raised" : "cleared",
+             alarm_manager_source_name(event->rule->source), event->value);
+}
+
+static int64_t wall_clock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*
+ * Options come from the environment, the linux target passes no arguments:
+ *   HOST_REPLAY=<file>     replay a capture of capture_manager instead of the scripted signals
+ *   HOST_GOLDEN=<file>     compare the broker messages against a golden file
+ *   HOST_GOLDEN_UPDATE=1   write the golden file instead
+ */
+void app_main(void)
+{
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    const char *replay_path = getenv("HOST_REPLAY");
+    const char *golden_path = getenv("HOST_GOLDEN");
+    const char *golden_update = getenv("HOST_GOLDEN_UPDATE");
+    bool replay = replay_path != NULL && replay_path[0] != '\0';
+
+    if (replay) {
+        if (replay_load(replay_path) != ESP_OK) {
+            exit(EXIT_FAILURE);
+        }
+        replay_setup_fakes();
+    } else {
+        fake_ds18b20_setup(1, ds18b20_temperature);
+        fake_dht_setup(dht22_temperature, dht22_humidity, CONFIG_HOST_DHT22_FAIL_EVERY);
+        fake_adc_setup(battery_voltage);
+    }
+    fake_mqtt_setup(CONFIG_HOST_MQTT_CONNECT_MS, CONFIG_HOST_MQTT_ACK_MS);
+
+    bool golden = golden_path != NULL && golden_path[0] != '\0';
+    if (golden && replay_golden_open(golden_path, golden_update != NULL && strcmp(golden_update, "1") == 0) != ESP_OK) {
+        exit(EXIT_FAILURE);
+    }
+
+    int64_t start_us = wall_clock_us();
+
+    // Same order as the boot graph of the firmware, run sequentially
+    ESP_ERROR_CHECK(mqtt_init(NULL, 0));
+    ESP_ERROR_CHECK(alarm_manager_init(alarm_event_handler));
+    ESP_ERROR_CHECK(i2c_bus_manager_init());
+    sht3x_manager_init();
+    bme280_manager_init();
+    ESP_ERROR_CHECK(ds18b20_manager_init());
+    ESP_ERROR_CHECK(dht22_manager_init());
+    ESP_ERROR_CHECK(adc_manager_init());
+
+    sampling_scheduler_init(virtual_clock_ms());
+    sampling_scheduler_set_enabled(SAMPLE_SOURCE_SHT3X, sht3x_manager_is_present());
+    sampling_scheduler_set_enabled(SAMPLE_SOURCE_BME280, bme280_manager_is_present());
+    sample_pipeline_init(virtual_clock_ms, NULL);
+
+    // Defaults of config_manager
+    const app_config_t cfg = {
+        .sample_period_ms = CONFIG_SAMPLE_PERIOD_MS,
+        .heartbeat_cycles = 6,
+        .publish_qos = 1,
+        .log_level = ESP_LOG_INFO,
+        .adaptive_sampling = CONFIG_SAMPLE_ADAPTIVE_DEFAULT,
+    };
+
+    uint32_t end_ms = replay ? REPLAY_LIMIT_MS : CONFIG_HOST_RUN_HOURS * HOUR_MS;
+    uint32_t samples = 0;
+
+    while (virtual_clock_ms() < end_ms && !(replay && replay_done())) {
+        uint32_t wait_ms = 0;
+        if (sample_pipeline_poll(&cfg, &wait_ms)) {
+            samples++;
+            continue;
+        }
+        alarm_manager_check_stale(virtual_clock_ms());
+        uint32_t step = wait_ms < MAX_IDLE_WAIT_MS ? wait_ms : MAX_IDLE_WAIT_MS;
+        virtual_clock_advance(step > 0 ? step : 1);
+    }
+
+    esp_err_t flushed = mqtt_manager_flush(FLUSH_TIMEOUT_MS);
+    int64_t wall_us = wall_clock_us() - start_us;
+    esp_err_t golden_ret = golden ? replay_golden_close() : ESP_OK;
+
+    fake_mqtt_stats_t broker;
+    fake_mqtt_get_stats(&broker);
+
+    uint32_t published = sample_pipeline_published();
+    printf("\n");
+    printf("simulated       %" PRIu32 " s in %" PRId64 " ms wall clock, %" PRId64 "x real time\n",
+           virtual_clock_ms() / 1000, wall_us / 1000,
+           wall_us > 0 ? (int64_t)virtual_clock_ms() * 1000 / wall_us : 0);
+    printf("samples         %" PRIu32 ", %" PRIu32 " telemetry messages\n", samples, published);
+    printf("throughput      %" PRId64 " samples/s\n", wall_us > 0 ? (int64_t)samples * 1000000 / wall_us : 0);
+    if (replay) {
+        printf("replayed        %" PRIu32 " captured reads%s\n", replay_reads(),
+               replay_done() ? "" : ", stopped at the time limit");
+    }
+    printf("broker          %" PRIu32 " connects, %" PRIu32 " messages, %" PRIu32 " bytes, %" PRIu32 " acked\n",
+           broker.connects, broker.published, broker.published_bytes, broker.acked);
+    printf("outbox peak     %" PRIu32 " bytes\n", broker.outbox_peak);
+    printf("alarms          %" PRIu32 " raised, %" PRIu32 " cleared\n", alarms_raised, alarms_cleared);
+    printf("invalid JSON    %" PRIu32 "\n", broker.invalid_json);
+    if (golden) {
+        printf("golden          %s\n", golden_ret == ESP_OK ? "match" : "MISMATCH");
+    }
+    fflush(stdout);
+
+    bool ok = flushed == ESP_OK && broker.published >= published && broker.invalid_json == 0 && golden_ret == ESP_OK;
+    if (replay) {
+        // Whatever alarms the capture raises are covered by the golden file
+        ok = ok && replay_done();
+    } else {
+        ok = ok && published > 0 && alarms_raised > 0 && alarms_raised == alarms_cleared;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    fflush(stdout);
+    exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
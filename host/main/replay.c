@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "capture_manager.h"
+#include "fake_sensors.h"
+#include "fake_mqtt.h"
+#include "replay.h"
+
+static const char *TAG = "replay";
+
+#define LINE_SIZE           512
+#define GOLDEN_LINE_SIZE    2048
+
+typedef struct {
+    int32_t raw0;
+    int32_t raw1;
+    bool failed;
+} replay_read_t;
+
+/* captured reads of one sensor, taken in order */
+typedef struct {
+    replay_read_t *reads;
+    size_t count;
+    size_t capacity;
+    size_t next;
+    bool started;
+    uint32_t taken_ms;      // Fakes ask once per value, the DHT22 twice at the same time
+} replay_stream_t;
+
+static replay_stream_t streams[CAPTURE_SOURCE_COUNT];
+
+// Values while a sensor has no captured reads: 25 °C, 25 °C / 45 %RH, half scale (1.65 V)
+static const replay_read_t defaults[CAPTURE_SOURCE_COUNT] = {
+    [CAPTURE_SOURCE_DS18B20] = { 400, 0, false },
+    [CAPTURE_SOURCE_DHT22] = { 250, 450, false },
+    [CAPTURE_SOURCE_ADC] = { 2048, 1650, false },
+};
+
+static FILE *golden = NULL;
+static bool golden_update = false;
+static bool golden_mismatch = false;
+static uint32_t golden_line = 0;
+
+static esp_err_t append(replay_stream_t *stream, const replay_read_t *read)
+{
+    if (stream->count == stream->capacity) {
+        size_t capacity = stream->capacity ? stream->capacity * 2 : 256;
+        replay_read_t *reads = realloc(stream->reads, capacity * sizeof(reads[0]));
+        if (reads == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        stream->reads = reads;
+        stream->capacity = capacity;
+    }
+    stream->reads[stream->count++] = *read;
+    return ESP_OK;
+}
+
+static int source_from_name(const char *name)
+{
+    for (int i = 0; i < CAPTURE_SOURCE_COUNT; i++) {
+        if (strcmp(name, capture_manager_source_name(i)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+esp_err_t replay_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char line[LINE_SIZE];
+    uint32_t total = 0;
+    esp_err_t ret = ESP_OK;
+
+    while (ret == ESP_OK && fgets(line, sizeof(line), f) != NULL) {
+        const char *cap = strstr(line, "CAP1 ");
+        if (cap == NULL) {
+            continue;
+        }
+
+        uint32_t ms;
+        char name[16];
+        int status;
+        replay_read_t read;
+        if (sscanf(cap, "CAP1 %" SCNu32 " %15s %d %" SCNd32 " %" SCNd32, &ms, name, &status, &read.raw0,
+                   &read.raw1) != 5) {
+            continue;
+        }
+        int source = source_from_name(name);
+        if (source < 0 || (source == CAPTURE_SOURCE_DS18B20 && read.raw1 != 0)) {
+            continue;
+        }
+        read.failed = status != ESP_OK;
+        ret = append(&streams[source], &read);
+        total++;
+    }
+    fclose(f);
+
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (total == 0) {
+        ESP_LOGE(TAG, "No captured reads in %s", path);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    ESP_LOGI(TAG, "%" PRIu32 " reads: %u DS18B20, %u DHT22, %u ADC", total,
+             (unsigned)streams[CAPTURE_SOURCE_DS18B20].count, (unsigned)streams[CAPTURE_SOURCE_DHT22].count,
+             (unsigned)streams[CAPTURE_SOURCE_ADC].count);
+    return ESP_OK;
+}
+
+/**
+ * @brief Read of a sensor at now_ms, the next one if the sensor was not read at now_ms yet
+ */
+static const replay_read_t *take(capture_source_t source, uint32_t now_ms)
+{
+    replay_stream_t *stream = &streams[source];
+
+    if (!stream->started || stream->taken_ms != now_ms) {
+        if (stream->started && stream->next < stream->count) {
+            stream->next++;
+        }
+        stream->started = true;
+        stream->taken_ms = now_ms;
+    }
+
+    if (stream->count == 0) {
+        return &defaults[source];
+    }
+    // Past the end the last read is held
+    return &stream->reads[stream->next < stream->count ? stream->next : stream->count - 1];
+}
+
+static int32_t ds18b20_raw(uint32_t now_ms)
+{
+    const replay_read_t *read = take(CAPTURE_SOURCE_DS18B20, now_ms);
+    return read->failed ? FAKE_SIGNAL_FAIL : read->raw0;
+}
+
+static int32_t dht22_temperature(uint32_t now_ms)
+{
+    const replay_read_t *read = take(CAPTURE_SOURCE_DHT22, now_ms);
+    return read->failed ? FAKE_SIGNAL_FAIL : read->raw0;
+}
+
+static int32_t dht22_humidity(uint32_t now_ms)
+{
+    const replay_read_t *read = take(CAPTURE_SOURCE_DHT22, now_ms);
+    return read->failed ? FAKE_SIGNAL_FAIL : read->raw1;
+}
+
+static int32_t adc_raw(uint32_t now_ms)
+{
+    const replay_read_t *read = take(CAPTURE_SOURCE_ADC, now_ms);
+    return read->failed ? FAKE_SIGNAL_FAIL : read->raw0;
+}
+
+static int32_t adc_millivolts(uint32_t now_ms)
+{
+    return take(CAPTURE_SOURCE_ADC, now_ms)->raw1;
+}
+
+void replay_setup_fakes(void)
+{
+    fake_ds18b20_setup_raw(1, ds18b20_raw);
+    fake_dht_setup(dht22_temperature, dht22_humidity, 0);
+    fake_adc_setup_raw(adc_raw, adc_millivolts);
+}
+
+/* The read at next is in use until the sensor is read again */
+static size_t taken(const replay_stream_t *stream)
+{
+    if (!stream->started) {
+        return 0;
+    }
+    return stream->next < stream->count ? stream->next + 1 : stream->count;
+}
+
+bool replay_done(void)
+{
+    for (int i = 0; i < CAPTURE_SOURCE_COUNT; i++) {
+        if (taken(&streams[i]) < streams[i].count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t replay_reads(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < CAPTURE_SOURCE_COUNT; i++) {
+        total += (uint32_t)taken(&streams[i]);
+    }
+    return total;
+}
+
+/* "<topic> <payload>" with line breaks and backslashes escaped, one message per line */
+static void format_message_line(char *out, size_t size, const char *topic, const char *data, int len)
+{
+    size_t pos = (size_t)snprintf(out, size, "%s ", topic);
+    for (int i = 0; i < len && pos + 3 < size; i++) {
+        if (data[i] == '\n') {
+            out[pos++] = '\\';
+            out[pos++] = 'n';
+        } else if (data[i] == '\\') {
+            out[pos++] = '\\';
+            out[pos++] = '\\';
+        } else {
+            out[pos++] = data[i];
+        }
+    }
+    out[pos] = '\0';
+}
+
+static void golden_sink(const char *topic, const char *data, int len, void *ctx)
+{
+    static char actual[GOLDEN_LINE_SIZE];
+    static char expected[GOLDEN_LINE_SIZE];
+
+    format_message_line(actual, sizeof(actual), topic, data, len);
+    golden_line++;
+
+    if (golden_update) {
+        fprintf(golden, "%s\n", actual);
+        return;
+    }
+    if (golden_mismatch) {
+        return;
+    }
+
+    if (fgets(expected, sizeof(expected), golden) == NULL) {
+        ESP_LOGE(TAG, "Golden line %" PRIu32 ": extra message %s", golden_line, actual);
+        golden_mismatch = true;
+        return;
+    }
+    expected[strcspn(expected, "\n")] = '\0';
+    if (strcmp(actual, expected) != 0) {
+        ESP_LOGE(TAG, "Golden line %" PRIu32 " differs\n  expected %s\n  actual   %s", golden_line, expected, actual);
+        golden_mismatch = true;
+    }
+}
+
+esp_err_t replay_golden_open(const char *path, bool update)
+{
+    golden = fopen(path, update ? "w" : "r");
+    if (golden == NULL) {
+        ESP_LOGE(TAG, "Failed to open golden file %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    golden_update = update;
+    golden_mismatch = false;
+    golden_line = 0;
+    fake_mqtt_set_sink(golden_sink, NULL);
+    return ESP_OK;
+}
+
+esp_err_t replay_golden_close(void)
+{
+    if (golden == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    fake_mqtt_set_sink(NULL, NULL);
+
+    char expected[GOLDEN_LINE_SIZE];
+    if (!golden_update && !golden_mismatch && fgets(expected, sizeof(expected), golden) != NULL) {
+        expected[strcspn(expected, "\n")] = '\0';
+        ESP_LOGE(TAG, "Golden line %" PRIu32 ": missing message %s", golden_line + 1, expected);
+        golden_mismatch = true;
+    }
+
+    fclose(golden);
+    golden = NULL;
+    if (golden_update) {
+        ESP_LOGI(TAG, "Wrote %" PRIu32 " messages to the golden file", golden_line);
+    }
+    return golden_mismatch ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Load the sensor reads of a capture
+ *
+ * Takes the CAP1 lines of capture_manager and skips everything else, so a
+ * console log or the output of "mosquitto_sub -v" on the capture topic
+ * load as they are. DS18B20 reads of other devices than the first are
+ * dropped, the pipeline samples only that one.
+ *
+ * @param path Capture file
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the file does not open,
+ *         ESP_ERR_INVALID_SIZE if it holds no reads, ESP_ERR_NO_MEM
+ */
+esp_err_t replay_load(const char *path);
+
+/**
+ * @brief Drive the DS18B20, DHT22 and ADC fakes from the loaded reads
+ *
+ * Every read of a sensor takes the next captured read of that sensor,
+ * failed reads fail again. Once a sensor has no reads left, its last
+ * value is held. ADC reads convert to the captured calibrated voltage,
+ * so voltages match the unit the capture was taken on.
+ */
+void replay_setup_fakes(void);
+
+/**
+ * @brief Whether every captured read was taken
+ */
+bool replay_done(void);
+
+/**
+ * @brief Number of captured reads taken so far
+ */
+uint32_t replay_reads(void);
+
+/**
+ * @brief Compare the broker messages against a golden file
+ *
+ * Every message is one line "<topic> <payload>", line breaks of the
+ * payload escaped as \n.
+ *
+ * @param path   Golden file
+ * @param update Write the file from this run instead of comparing
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the file does not open
+ */
+esp_err_t replay_golden_open(const char *path, bool update);
+
+/**
+ * @brief Finish the golden comparison, logs the first differing message
+ *
+ * @return ESP_OK if every message matched and none was missing or extra,
+ *         ESP_ERR_INVALID_RESPONSE otherwise
+ */
+esp_err_t replay_golden_close(void);
+
+#ifdef __cplusplus
+}
+#endif
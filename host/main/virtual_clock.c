@@ -0,0 +1,32 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "fake_mqtt.h"
+#include "virtual_clock.h"
+
+static uint32_t now_ms = 0;
+
+uint32_t virtual_clock_ms(void)
+{
+    return now_ms;
+}
+
+void virtual_clock_advance(uint32_t ms)
+{
+    now_ms += ms;
+    fake_mqtt_run(now_ms);
+}
+
+/*
+ * The component links with --wrap=vTaskDelay and --wrap=xTaskGetTickCount,
+ * so the waits of the managers (DS18B20 conversion, DHT22 warm-up, MQTT
+ * flush) move the virtual clock instead of sleeping.
+ */
+void __wrap_vTaskDelay(const TickType_t ticks)
+{
+    virtual_clock_advance(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t __wrap_xTaskGetTickCount(void)
+{
+    return (TickType_t)(now_ms / portTICK_PERIOD_MS);
+}
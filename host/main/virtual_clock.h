@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Milliseconds of simulated time since start
+ */
+uint32_t virtual_clock_ms(void);
+
+/**
+ * @brief Advance the simulated time
+ *
+ * Returns at once. Broker events that fall due meanwhile are delivered
+ * before it returns, as the MQTT task would have done during the wait.
+ *
+ * @param ms Time to advance
+ */
+void virtual_clock_advance(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,81 @@
+#include <string.h>
+#include "adaptive_rate.h"
+
+void adaptive_rate_init(adaptive_rate_t *state, const adaptive_rate_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+    state->period_ms = config->max_period_ms;
+}
+
+/**
+ * @brief Check if variance of the window exceeds stddev_threshold^2
+ *
+ * Compares n * sum(x^2) - sum(x)^2 against n^2 * threshold^2 so no
+ * division or square root is needed.
+ */
+static bool window_is_noisy(const adaptive_rate_t *state, int32_t stddev_threshold)
+{
+    if (stddev_threshold <= 0 || state->count < 2) {
+        return false;
+    }
+
+    // Offset by the first sample to keep the sums small
+    int64_t base = state->window[0];
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    for (uint8_t i = 0; i < state->count; i++) {
+        int64_t x = state->window[i] - base;
+        sum += x;
+        sum_sq += x * x;
+    }
+
+    int64_t n = state->count;
+    int64_t scaled_variance = n * sum_sq - sum * sum;
+    int64_t limit = n * n * (int64_t)stddev_threshold * stddev_threshold;
+    return scaled_variance > limit;
+}
+
+uint32_t adaptive_rate_update(adaptive_rate_t *state, const adaptive_rate_config_t *config,
+                              int32_t value, uint32_t now_ms)
+{
+    bool transient = false;
+
+    if (state->has_last && config->rate_threshold > 0) {
+        uint32_t dt_ms = now_ms - state->last_ms;
+        if (dt_ms > 0) {
+            int64_t rate = ((int64_t)value - state->last_value) * 60000 / (int64_t)dt_ms;
+            if (rate < 0) {
+                rate = -rate;
+            }
+            transient = rate > config->rate_threshold;
+        }
+    }
+
+    state->window[state->head] = value;
+    state->head = (uint8_t)((state->head + 1) % ADAPTIVE_RATE_WINDOW);
+    if (state->count < ADAPTIVE_RATE_WINDOW) {
+        state->count++;
+    }
+
+    if (!transient) {
+        transient = window_is_noisy(state, config->stddev_threshold);
+    }
+
+    if (transient) {
+        state->period_ms = config->min_period_ms;
+    } else {
+        // Decay back towards the floor rate
+        uint32_t next = state->period_ms + state->period_ms / 2;
+        state->period_ms = next > config->max_period_ms ? config->max_period_ms : next;
+    }
+
+    if (state->period_ms < config->min_period_ms) {
+        state->period_ms = config->min_period_ms;
+    }
+
+    state->has_last = true;
+    state->last_value = value;
+    state->last_ms = now_ms;
+
+    return state->period_ms;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of recent samples used for the variance estimate
+#define ADAPTIVE_RATE_WINDOW 8
+
+/**
+ * @brief Adaptive sampling policy parameters
+ *
+ * Value units are those of the fed samples (e.g. 0.01 °C or mV).
+ */
+typedef struct {
+    uint32_t min_period_ms;     // Fastest period, used during transients
+    uint32_t max_period_ms;     // Floor rate, period the policy decays back to when stable
+    int32_t rate_threshold;     // |change per minute| that triggers fast sampling (0 disables)
+    int32_t stddev_threshold;   // Standard deviation over the window that triggers fast sampling (0 disables)
+} adaptive_rate_config_t;
+
+/**
+ * @brief Adaptive sampling state of one sensor
+ */
+typedef struct {
+    int32_t window[ADAPTIVE_RATE_WINDOW];
+    uint8_t head;
+    uint8_t count;
+    bool has_last;
+    int32_t last_value;
+    uint32_t last_ms;
+    uint32_t period_ms;         // Current period
+} adaptive_rate_t;
+
+/**
+ * @brief Reset policy state, starting at the floor rate
+ *
+ * @param state  Policy state
+ * @param config Policy parameters
+ */
+void adaptive_rate_init(adaptive_rate_t *state, const adaptive_rate_config_t *config);
+
+/**
+ * @brief Feed a new sample and get the period until the next one
+ *
+ * The period drops to min_period_ms as soon as the derivative since the
+ * previous sample or the standard deviation of the recent window passes
+ * its threshold. While the signal is stable the period grows by half per
+ * sample until it is back at max_period_ms.
+ *
+ * Pure integer code without platform dependencies, so recorded traces can
+ * be replayed through it on the host.
+ *
+ * @param state  Policy state
+ * @param config Policy parameters
+ * @param value  Sample value
+ * @param now_ms Sample time in milliseconds
+ * @return Period until the next sample in milliseconds
+ */
+uint32_t adaptive_rate_update(adaptive_rate_t *state, const adaptive_rate_config_t *config,
+                              int32_t value, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,5 @@
 #include "adc_manager.h"
+#include "capture_manager.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
@@ -174,9 +175,10 @@ esp_err_t adc_manager_init(void)
  * and compensates for the external voltage divider.
  * 
  * @param voltage_mv Pointer to store the measured voltage in millivolts
+ * @param capture Record the read with capture_manager
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t adc_manager_read_voltage(int *voltage_mv)
+static esp_err_t read_voltage(int *voltage_mv, bool capture)
 {
     // Validate input parameter
     if (!voltage_mv) {
@@ -194,6 +196,9 @@ esp_err_t adc_manager_read_voltage(int *voltage_mv)
     int adc_raw = 0;
     esp_err_t ret = adc_oneshot_read(adc_handle, ADC_CHANNEL, &adc_raw);
     if (ret != ESP_OK) {
+        if (capture) {
+            CAPTURE(CAPTURE_SOURCE_ADC, ret, adc_raw, 0);
+        }
         ESP_LOGE(TAG, "Failed to read ADC: %s", esp_err_to_name(ret));
         return ret;
     }
@@ -201,6 +206,10 @@ esp_err_t adc_manager_read_voltage(int *voltage_mv)
     // Convert to voltage in millivolts
     int voltage_uncorrected = 0;
     ret = convert_raw_to_voltage(adc_raw, &voltage_uncorrected);
+    if (capture) {
+        // The calibrated value is captured as well, a replay cannot redo the eFuse curve fitting
+        CAPTURE(CAPTURE_SOURCE_ADC, ret, adc_raw, voltage_uncorrected);
+    }
     if (ret != ESP_OK) {
         return ret;
     }
@@ -212,4 +221,14 @@ esp_err_t adc_manager_read_voltage(int *voltage_mv)
              adc_raw, voltage_uncorrected, *voltage_mv);
     
     return ESP_OK;
+}
+
+esp_err_t adc_manager_read_voltage(int *voltage_mv)
+{
+    return read_voltage(voltage_mv, true);
+}
+
+esp_err_t adc_manager_read_voltage_uncaptured(int *voltage_mv)
+{
+    return read_voltage(voltage_mv, false);
 }
\ No newline at end of file
@@ -43,6 +43,17 @@ esp_err_t adc_manager_init(void);
  */
 esp_err_t adc_manager_read_voltage(int *voltage_mv);
 
+/**
+ * @brief Read voltage like adc_manager_read_voltage() without recording it
+ * 
+ * For reads outside the sampling, e.g. benchmarks, which would otherwise
+ * show up as samples in a capture replay.
+ * 
+ * @param voltage_mv Pointer to store the measured voltage in millivolts (required)
+ * @return Same as adc_manager_read_voltage()
+ */
+esp_err_t adc_manager_read_voltage_uncaptured(int *voltage_mv);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+#include "sleep_manager.h"
+#include "alarm_manager.h"
+
+static const char *TAG = "alarm_manager";
+
+// Kconfig temperatures are in 0.1 °C, samples in 0.01 °C
+#define TEMP_FROM_KCONFIG(x)    ((int32_t)(x) * 10)
+#define STALE_TIMEOUT_MS        ((int32_t)CONFIG_ALARM_STALE_TIMEOUT_S * 1000)
+#define ALARM_STATE_MAGIC       0x414C4D31u     // "ALM1"
+
+static const alarm_rule_t rules[] = {
+    { ALARM_SOURCE_DS18B20_TEMP, ALARM_RULE_HIGH, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HIGH), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DS18B20_TEMP, ALARM_RULE_LOW,  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_LOW),  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DS18B20_TEMP, ALARM_RULE_RATE, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_RATE), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DS18B20_TEMP, ALARM_RULE_STALE, STALE_TIMEOUT_MS, 0 },
+    { ALARM_SOURCE_DHT22_TEMP,   ALARM_RULE_HIGH, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HIGH), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DHT22_TEMP,   ALARM_RULE_LOW,  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_LOW),  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DHT22_TEMP,   ALARM_RULE_RATE, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_RATE), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_DHT22_TEMP,   ALARM_RULE_STALE, STALE_TIMEOUT_MS, 0 },
+    { ALARM_SOURCE_DHT22_HUMIDITY, ALARM_RULE_STALE, STALE_TIMEOUT_MS, 0 },
+    { ALARM_SOURCE_VOLTAGE,      ALARM_RULE_STALE, STALE_TIMEOUT_MS, 0 },
+    // Optional I2C sensors, no stale rule as an absent sensor never reports
+    { ALARM_SOURCE_SHT3X_TEMP,   ALARM_RULE_HIGH, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HIGH), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_SHT3X_TEMP,   ALARM_RULE_LOW,  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_LOW),  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_SHT3X_TEMP,   ALARM_RULE_RATE, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_RATE), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_BME280_TEMP,  ALARM_RULE_HIGH, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HIGH), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_BME280_TEMP,  ALARM_RULE_LOW,  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_LOW),  TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+    { ALARM_SOURCE_BME280_TEMP,  ALARM_RULE_RATE, TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_RATE), TEMP_FROM_KCONFIG(CONFIG_ALARM_TEMP_HYSTERESIS) },
+};
+
+#define RULE_COUNT (sizeof(rules) / sizeof(rules[0]))
+
+// Last sample of each source
+typedef struct {
+    bool seen;              // At least one sample (or stale check) recorded
+    bool has_value;         // last_value is valid
+    int32_t last_value;
+    uint32_t last_ms;
+} source_state_t;
+
+/**
+ * @brief State retained in RTC memory, so active alarms, rate and stale
+ *        references carry over deep sleep in duty-cycle mode
+ */
+typedef struct {
+    uint32_t magic;         // ALARM_STATE_MAGIC once initialized
+    source_state_t sources[ALARM_SOURCE_COUNT];
+    bool rule_active[RULE_COUNT];
+} alarm_state_t;
+
+static RTC_DATA_ATTR alarm_state_t retained;
+static alarm_callback_t alarm_callback = NULL;
+
+static const char *const source_names[ALARM_SOURCE_COUNT] = {
+    "DS18B20", "DHT22", "DHT22_humidity", "voltage", "SHT3x", "BME280",
+};
+
+static const char *const rule_names[] = {
+    "high", "low", "rate", "stale",
+};
+
+static void set_rule_state(size_t index, bool active, int32_t value, uint32_t now_ms)
+{
+    if (retained.rule_active[index] == active) {
+        return;
+    }
+    retained.rule_active[index] = active;
+
+    const alarm_rule_t *rule = &rules[index];
+    ESP_LOGW(TAG, "Alarm %s %s on %s (value %ld, threshold %ld)",
+             rule_names[rule->type], active ? "RAISED" : "cleared",
+             source_names[rule->source], (long)value, (long)rule->threshold);
+
+    if (alarm_callback) {
+        alarm_event_t event = {
+            .rule = rule,
+            .active = active,
+            .value = value,
+            .timestamp_ms = now_ms,
+        };
+        alarm_callback(&event);
+    }
+}
+
+/**
+ * @brief Evaluate threshold with hysteresis
+ *
+ * @param above true for "raise when above threshold" rules
+ */
+static bool evaluate_threshold(bool active, int32_t value, int32_t threshold, int32_t hysteresis, bool above)
+{
+    if (above) {
+        return active ? value > threshold - hysteresis : value > threshold;
+    }
+    return active ? value < threshold + hysteresis : value < threshold;
+}
+
+esp_err_t alarm_manager_init(alarm_callback_t callback)
+{
+    if (callback == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    alarm_callback = callback;
+    if (sleep_manager_is_wake() && retained.magic == ALARM_STATE_MAGIC) {
+        ESP_LOGI(TAG, "Alarm state kept across deep sleep");
+        return ESP_OK;
+    }
+
+    retained = (alarm_state_t) { .magic = ALARM_STATE_MAGIC };
+    ESP_LOGI(TAG, "Alarm manager initialized with %d rules", (int)RULE_COUNT);
+    return ESP_OK;
+}
+
+void alarm_manager_feed(alarm_source_t source, int32_t value, uint32_t now_ms)
+{
+    if (source >= ALARM_SOURCE_COUNT) {
+        return;
+    }
+
+    source_state_t *state = &retained.sources[source];
+
+    for (size_t i = 0; i < RULE_COUNT; i++) {
+        const alarm_rule_t *rule = &rules[i];
+        if (rule->source != source) {
+            continue;
+        }
+
+        switch (rule->type) {
+            case ALARM_RULE_HIGH:
+                set_rule_state(i, evaluate_threshold(retained.rule_active[i], value, rule->threshold, rule->hysteresis, true),
+                               value, now_ms);
+                break;
+
+            case ALARM_RULE_LOW:
+                set_rule_state(i, evaluate_threshold(retained.rule_active[i], value, rule->threshold, rule->hysteresis, false),
+                               value, now_ms);
+                break;
+
+            case ALARM_RULE_RATE: {
+                uint32_t dt_ms = now_ms - state->last_ms;
+                if (rule->threshold <= 0 || !state->has_value || dt_ms == 0) {
+                    break;
+                }
+                int64_t rate = ((int64_t)(value - state->last_value) * 60000) / (int64_t)dt_ms;
+                if (rate < 0) {
+                    rate = -rate;
+                }
+                int32_t rate32 = rate > INT32_MAX ? INT32_MAX : (int32_t)rate;
+                set_rule_state(i, evaluate_threshold(retained.rule_active[i], rate32, rule->threshold, rule->hysteresis, true),
+                               rate32, now_ms);
+                break;
+            }
+
+            case ALARM_RULE_STALE:
+                set_rule_state(i, false, value, now_ms);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    state->seen = true;
+    state->has_value = true;
+    state->last_value = value;
+    state->last_ms = now_ms;
+}
+
+void alarm_manager_check_stale(uint32_t now_ms)
+{
+    for (size_t i = 0; i < RULE_COUNT; i++) {
+        const alarm_rule_t *rule = &rules[i];
+        if (rule->type != ALARM_RULE_STALE || rule->threshold <= 0) {
+            continue;
+        }
+
+        source_state_t *state = &retained.sources[rule->source];
+        if (!state->seen) {
+            // Sensor never reported, count its age from the first check
+            state->seen = true;
+            state->last_ms = now_ms;
+        }
+
+        uint32_t age_ms = now_ms - state->last_ms;
+        if (age_ms > (uint32_t)rule->threshold) {
+            set_rule_state(i, true, (int32_t)age_ms, now_ms);
+        }
+    }
+}
+
+const char *alarm_manager_source_name(alarm_source_t source)
+{
+    return source < ALARM_SOURCE_COUNT ? source_names[source] : "?";
+}
+
+const char *alarm_manager_rule_name(alarm_rule_type_t type)
+{
+    return (size_t)type < sizeof(rule_names) / sizeof(rule_names[0]) ? rule_names[type] : "?";
+}
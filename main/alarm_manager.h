@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Measured quantities the alarm rules can watch
+ *
+ * Values are fed as integers: temperatures in 0.01 °C,
+ * humidity in 0.1 %RH and voltage in mV.
+ */
+typedef enum {
+    ALARM_SOURCE_DS18B20_TEMP = 0,
+    ALARM_SOURCE_DHT22_TEMP,
+    ALARM_SOURCE_DHT22_HUMIDITY,
+    ALARM_SOURCE_VOLTAGE,
+    ALARM_SOURCE_SHT3X_TEMP,
+    ALARM_SOURCE_BME280_TEMP,
+    ALARM_SOURCE_COUNT
+} alarm_source_t;
+
+/**
+ * @brief Alarm rule types
+ */
+typedef enum {
+    ALARM_RULE_HIGH = 0,    // Value above threshold, clears below threshold - hysteresis
+    ALARM_RULE_LOW,         // Value below threshold, clears above threshold + hysteresis
+    ALARM_RULE_RATE,        // |change per minute| above threshold, clears below threshold - hysteresis
+    ALARM_RULE_STALE,       // No sample for threshold ms, clears on next sample
+} alarm_rule_type_t;
+
+/**
+ * @brief Alarm rule definition
+ */
+typedef struct {
+    alarm_source_t source;
+    alarm_rule_type_t type;
+    int32_t threshold;      // Value units (HIGH/LOW), value units per minute (RATE) or ms (STALE)
+    int32_t hysteresis;     // Value units, unused for STALE
+} alarm_rule_t;
+
+/**
+ * @brief Alarm state change reported to the callback
+ */
+typedef struct {
+    const alarm_rule_t *rule;
+    bool active;            // true when raised, false when cleared
+    int32_t value;          // Value (or rate, or sample age in ms) that changed the state
+    uint32_t timestamp_ms;  // Time of the evaluation
+} alarm_event_t;
+
+/**
+ * @brief Alarm callback, called synchronously from the evaluating task
+ */
+typedef void (*alarm_callback_t)(const alarm_event_t *event);
+
+/**
+ * @brief Initialize alarm manager with the rules from Kconfig
+ *
+ * After a wake from deep sleep the alarm states and last samples of the
+ * previous cycle are kept, call after sleep_manager_init().
+ *
+ * @param callback Function called on every alarm state change
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if callback is NULL
+ */
+esp_err_t alarm_manager_init(alarm_callback_t callback);
+
+/**
+ * @brief Evaluate all rules of a source against a new sample
+ *
+ * Must be called right after each sample is read so that alarm latency
+ * is bounded by the sensor conversion time.
+ *
+ * @param source Source of the sample
+ * @param value  Sample value in the units of the source
+ * @param now_ms Sample time in milliseconds
+ */
+void alarm_manager_feed(alarm_source_t source, int32_t value, uint32_t now_ms);
+
+/**
+ * @brief Evaluate stale rules of all sources
+ *
+ * @param now_ms Current time in milliseconds
+ */
+void alarm_manager_check_stale(uint32_t now_ms);
+
+/**
+ * @brief Get printable name of a source
+ */
+const char *alarm_manager_source_name(alarm_source_t source);
+
+/**
+ * @brief Get printable name of a rule type
+ */
+const char *alarm_manager_rule_name(alarm_rule_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
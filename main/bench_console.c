@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_console.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_system.h"
+#include "argtable3/argtable3.h"
+#include "sdkconfig.h"
+#include "ds18b20_manager.h"
+#include "adc_manager.h"
+#include "ssd1306_manager.h"
+#include "mqtt_manager.h"
+#include "power_manager.h"
+#include "sample_pipeline.h"
+#include "messages/message_formatter.h"
+#include "bench_console.h"
+
+#if CONFIG_BENCH_CONSOLE
+
+static const char *TAG = "bench_console";
+
+#define BENCH_DEFAULT_RUNS      100
+#define BENCH_MAX_RUNS          1000
+#define BENCH_TOPIC_SIZE        96
+#define CONSOLE_TASK_STACK      6144    // TLS writes of "bench publish" run on the console task
+#define SENSOR_LOCK_TIMEOUT_MS  5000    // A DS18B20 sample takes about one second
+#define DISPLAY_TIMEOUT_MS      1000
+
+/**
+ * @brief One benchmarked operation
+ */
+typedef struct {
+    const char *name;
+    esp_err_t (*run)(void);
+    bool sensors;           // Drives sensor managers, sampling is held off meanwhile
+    bool connected;         // Needs the MQTT connection
+} bench_op_t;
+
+static char publish_topic[BENCH_TOPIC_SIZE];
+static int publish_qos = 0;
+
+static const sensor_sample_t json_sample = {
+    .id = "28FF641E0F3C0A1B",
+    .sensor = "DS18B20",
+    .period_ms = 10000,
+    .fields = SENSOR_SAMPLE_TEMPERATURE,
+    .temperature = 2143,
+};
+
+static esp_err_t run_onewire(void)
+{
+    int32_t temperature;
+    return ds18b20_manager_read_scratchpad(0, &temperature);
+}
+
+static esp_err_t run_i2c(void)
+{
+    return ssd1306_manager_flush_full(DISPLAY_TIMEOUT_MS);
+}
+
+static esp_err_t run_adc(void)
+{
+    int voltage_mv;
+    return adc_manager_read_voltage_uncaptured(&voltage_mv);
+}
+
+static esp_err_t run_json(void)
+{
+    char *json = format_message(&json_sample);
+    if (json == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    free(json);
+    return ESP_OK;
+}
+
+/* Formats like the sample pipeline, then goes through the client and TLS write */
+static esp_err_t run_publish(void)
+{
+    char *json = format_message(&json_sample);
+    if (json == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    int msg_id = mqtt_manager_publish(publish_topic, json, publish_qos, false);
+    free(json);
+    return msg_id >= 0 ? ESP_OK : ESP_FAIL;
+}
+
+static const bench_op_t ops[] = {
+    { "onewire", run_onewire, true, false },
+    { "i2c", run_i2c, false, false },
+    { "adc", run_adc, true, false },
+    { "json", run_json, false, false },
+    { "publish", run_publish, false, true },
+};
+
+static struct {
+    struct arg_str *op;
+    struct arg_int *runs;
+    struct arg_int *qos;
+    struct arg_end *end;
+} bench_args;
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sort the samples and print min/mean/p99/max
+ */
+static void print_stats(const char *unit, uint32_t *samples, int count)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    qsort(samples, count, sizeof(samples[0]), compare_u32);
+
+    // Nearest-rank percentile
+    int p99 = (count * 99 + 99) / 100 - 1;
+    printf("%-7s %10" PRIu32 " %10" PRIu64 " %10" PRIu32 " %10" PRIu32 "\n", unit, samples[0], sum / count,
+           samples[p99], samples[count - 1]);
+}
+
+static int run_bench(const bench_op_t *op, int runs)
+{
+    if (op->connected && !mqtt_manager_is_connected()) {
+        printf("MQTT not connected, messages would only be buffered\n");
+        return 1;
+    }
+
+    uint32_t *us = malloc(2 * runs * sizeof(uint32_t));
+    if (us == NULL) {
+        printf("Out of memory for %d samples\n", runs);
+        return 1;
+    }
+    uint32_t *cycles = &us[runs];
+
+    if (op->sensors && sample_pipeline_lock(SENSOR_LOCK_TIMEOUT_MS) != ESP_OK) {
+        printf("Sensors busy, try again\n");
+        free(us);
+        return 1;
+    }
+
+    // Fixed CPU clock for the whole run, so cycles and time agree
+    power_manager_lock_timing();
+
+    int failed = 0;
+    esp_err_t first_error = ESP_OK;
+    uint32_t heap_before = esp_get_free_heap_size();
+
+    for (int i = 0; i < runs; i++) {
+        int64_t start_us = esp_timer_get_time();
+        esp_cpu_cycle_count_t start_cycles = esp_cpu_get_cycle_count();
+        esp_err_t ret = op->run();
+        cycles[i] = (uint32_t)(esp_cpu_get_cycle_count() - start_cycles);
+        us[i] = (uint32_t)(esp_timer_get_time() - start_us);
+
+        if (ret != ESP_OK) {
+            if (failed++ == 0) {
+                first_error = ret;
+            }
+        }
+    }
+
+    int32_t heap_delta = (int32_t)(esp_get_free_heap_size() - heap_before);
+    power_manager_unlock_timing();
+    if (op->sensors) {
+        sample_pipeline_unlock();
+    }
+
+    printf("bench %s: %d runs", op->name, runs);
+    if (failed > 0) {
+        printf(", %d failed (%s)", failed, esp_err_to_name(first_error));
+    }
+    printf("\n%-7s %10s %10s %10s %10s\n", "", "min", "mean", "p99", "max");
+    print_stats("us", us, runs);
+    print_stats("cycles", cycles, runs);
+    printf("heap    %+" PRId32 " bytes free\n", heap_delta);
+
+    free(us);
+    return failed == runs ? 1 : 0;
+}
+
+static int bench_command(int argc, char **argv)
+{
+    if (arg_parse(argc, argv, (void **)&bench_args) != 0) {
+        arg_print_errors(stderr, bench_args.end, argv[0]);
+        return 1;
+    }
+
+    int runs = bench_args.runs->count > 0 ? bench_args.runs->ival[0] : BENCH_DEFAULT_RUNS;
+    if (runs < 1 || runs > BENCH_MAX_RUNS) {
+        printf("Runs must be 1 to %d\n", BENCH_MAX_RUNS);
+        return 1;
+    }
+    publish_qos = bench_args.qos->count > 0 ? bench_args.qos->ival[0] : 0;
+    if (publish_qos < 0 || publish_qos > 2) {
+        printf("QoS must be 0, 1 or 2\n");
+        return 1;
+    }
+
+    const char *name = bench_args.op->sval[0];
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        if (strcmp(name, ops[i].name) == 0) {
+            return run_bench(&ops[i], runs);
+        }
+    }
+    printf("Unknown operation %s\n", name);
+    return 1;
+}
+
+esp_err_t bench_console_init(const char *topic)
+{
+    snprintf(publish_topic, sizeof(publish_topic), "%s", topic);
+
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "thermometer>";
+    repl_config.task_stack_size = CONSOLE_TASK_STACK;
+
+#if CONFIG_ESP_CONSOLE_UART_DEFAULT || CONFIG_ESP_CONSOLE_UART_CUSTOM
+    esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_uart(&hw_config, &repl_config, &repl);
+#elif CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    esp_console_dev_usb_serial_jtag_config_t hw_config = ESP_CONSOLE_DEV_USB_SERIAL_JTAG_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_usb_serial_jtag(&hw_config, &repl_config, &repl);
+#else
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to create console: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    bench_args.op = arg_str1(NULL, NULL, "<op>", "onewire, i2c, adc, json or publish");
+    bench_args.runs = arg_int0("n", "runs", "<runs>", "number of runs, default 100");
+    bench_args.qos = arg_int0("q", "qos", "<qos>", "QoS of bench publish, default 0");
+    bench_args.end = arg_end(3);
+
+    const esp_console_cmd_t bench_cmd = {
+        .command = "bench",
+        .help = "Time an operation on the device: min/mean/p99/max us and CPU cycles, heap delta",
+        .func = bench_command,
+        .argtable = &bench_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&bench_cmd));
+    ESP_ERROR_CHECK(esp_console_register_help_command());
+
+    ret = esp_console_start_repl(repl);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start console: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Benchmark console started, type \"help\"");
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t bench_console_init(const char *publish_topic)
+{
+    return ESP_OK;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the serial console with the benchmark commands
+ *
+ *   bench onewire|i2c|adc|json|publish [-n <runs>] [-q <qos>]
+ *
+ * Each run of the operation is timed with esp_timer and the CPU cycle
+ * counter, the command prints min/mean/p99/max of both and the change of
+ * the free heap over all runs. Sensor benchmarks hold off the sample
+ * pipeline while they run. Without CONFIG_BENCH_CONSOLE nothing is started.
+ *
+ * Call once the sensor managers, the display and the sample pipeline are
+ * initialized.
+ *
+ * @param publish_topic Topic of the "bench publish" messages
+ * @return ESP_OK on success, error of the console setup otherwise
+ */
+esp_err_t bench_console_init(const char *publish_topic);
+
+#ifdef __cplusplus
+}
+#endif
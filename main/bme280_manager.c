@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "i2c_bus_manager.h"
+#include "messages/fixed_point.h"
+#include "bme280_manager.h"
+
+static const char *TAG = "bme280_manager";
+
+#define BME280_I2C_FREQ_HZ          400000
+#define BME280_TIMEOUT_MS           100
+#define BME280_CHIP_ID              0x60
+
+#define BME280_REG_CALIB_TP         0x88    // dig_T1 .. dig_H1, 26 bytes
+#define BME280_REG_CHIP_ID          0xD0
+#define BME280_REG_CALIB_H          0xE1    // dig_H2 .. dig_H6, 7 bytes
+#define BME280_REG_CTRL_HUM         0xF2
+#define BME280_REG_CTRL_MEAS        0xF4
+#define BME280_REG_DATA             0xF7    // press[3], temp[3], hum[2]
+
+#define BME280_CTRL_HUM_X1          0x01
+#define BME280_CTRL_MEAS_FORCED     ((1 << 5) | (0 << 2) | 0x01)   // osrs_t x1, pressure skipped, forced mode
+#define BME280_MEASUREMENT_MS       10      // 1.25 + 2.3 * T + 2.3 * H + 0.575 ms, rounded up
+
+// Round up and add one tick, vTaskDelay() may return up to a tick early
+#define BME280_MEASUREMENT_TICKS    ((BME280_MEASUREMENT_MS + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS + 1)
+
+static const uint16_t bme280_addresses[] = { 0x76, 0x77 };
+
+/**
+ * @brief Factory calibration, only the temperature and humidity part
+ */
+typedef struct {
+    uint16_t dig_T1;
+    int16_t dig_T2;
+    int16_t dig_T3;
+    uint8_t dig_H1;
+    int16_t dig_H2;
+    uint8_t dig_H3;
+    int16_t dig_H4;
+    int16_t dig_H5;
+    int8_t dig_H6;
+} bme280_calib_t;
+
+static i2c_master_dev_handle_t dev = NULL;
+static bme280_calib_t calib;
+
+static esp_err_t read_registers(uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_bus_manager_transfer(dev, &reg, 1, data, len, BME280_TIMEOUT_MS);
+}
+
+static esp_err_t write_register(uint8_t reg, uint8_t value)
+{
+    const uint8_t data[] = { reg, value };
+    return i2c_bus_manager_transfer(dev, data, sizeof(data), NULL, 0, BME280_TIMEOUT_MS);
+}
+
+static esp_err_t load_calibration(void)
+{
+    uint8_t tp[26];
+    uint8_t h[7];
+
+    esp_err_t ret = read_registers(BME280_REG_CALIB_TP, tp, sizeof(tp));
+    if (ret == ESP_OK) {
+        ret = read_registers(BME280_REG_CALIB_H, h, sizeof(h));
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    calib.dig_T1 = (uint16_t)(tp[1] << 8 | tp[0]);
+    calib.dig_T2 = (int16_t)(tp[3] << 8 | tp[2]);
+    calib.dig_T3 = (int16_t)(tp[5] << 8 | tp[4]);
+    calib.dig_H1 = tp[25];
+    calib.dig_H2 = (int16_t)(h[1] << 8 | h[0]);
+    calib.dig_H3 = h[2];
+    calib.dig_H4 = (int16_t)((int8_t)h[3] * 16 | (h[4] & 0x0F));
+    calib.dig_H5 = (int16_t)((int8_t)h[5] * 16 | (h[4] >> 4));
+    calib.dig_H6 = (int8_t)h[6];
+    return ESP_OK;
+}
+
+esp_err_t bme280_manager_init(void)
+{
+    for (size_t i = 0; i < sizeof(bme280_addresses) / sizeof(bme280_addresses[0]); i++) {
+        if (i2c_bus_manager_add_device(bme280_addresses[i], BME280_I2C_FREQ_HZ, &dev) != ESP_OK) {
+            continue;
+        }
+
+        uint8_t chip_id = 0;
+        if (read_registers(BME280_REG_CHIP_ID, &chip_id, 1) != ESP_OK || chip_id != BME280_CHIP_ID) {
+            // Something else lives at this address (e.g. a BMP280 with ID 0x58)
+            ESP_LOGW(TAG, "Device at 0x%02X is not a BME280 (chip id 0x%02X)", bme280_addresses[i], chip_id);
+            i2c_master_bus_rm_device(dev);
+            dev = NULL;
+            continue;
+        }
+
+        esp_err_t ret = load_calibration();
+        if (ret == ESP_OK) {
+            // Humidity oversampling only takes effect after the next ctrl_meas write
+            ret = write_register(BME280_REG_CTRL_HUM, BME280_CTRL_HUM_X1);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure BME280: %s", esp_err_to_name(ret));
+            i2c_master_bus_rm_device(dev);
+            dev = NULL;
+            return ret;
+        }
+
+        ESP_LOGI(TAG, "BME280 found at address 0x%02X", bme280_addresses[i]);
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "No BME280 sensor found");
+    return ESP_ERR_NOT_FOUND;
+}
+
+bool bme280_manager_is_present(void)
+{
+    return dev != NULL;
+}
+
+/**
+ * @brief Temperature compensation from the datasheet, result in 0.01 °C
+ */
+static int32_t compensate_temperature(int32_t adc_T, int32_t *t_fine)
+{
+    int32_t var1 = ((((adc_T >> 3) - ((int32_t)calib.dig_T1 << 1))) * ((int32_t)calib.dig_T2)) >> 11;
+    int32_t var2 = (((((adc_T >> 4) - ((int32_t)calib.dig_T1)) * ((adc_T >> 4) - ((int32_t)calib.dig_T1))) >> 12) *
+                    ((int32_t)calib.dig_T3)) >> 14;
+
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+/**
+ * @brief Humidity compensation from the datasheet, result in %RH as Q22.10
+ */
+static uint32_t compensate_humidity(int32_t adc_H, int32_t t_fine)
+{
+    int32_t v = t_fine - (int32_t)76800;
+
+    v = (((((adc_H << 14) - (((int32_t)calib.dig_H4) << 20) - (((int32_t)calib.dig_H5) * v)) +
+           ((int32_t)16384)) >> 15) *
+         (((((((v * ((int32_t)calib.dig_H6)) >> 10) * (((v * ((int32_t)calib.dig_H3)) >> 11) + ((int32_t)32768))) >> 10) +
+            ((int32_t)2097152)) * ((int32_t)calib.dig_H2) + 8192) >> 14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * ((int32_t)calib.dig_H1)) >> 4);
+    v = v < 0 ? 0 : v;
+    v = v > 419430400 ? 419430400 : v;
+
+    return (uint32_t)(v >> 12);
+}
+
+esp_err_t bme280_manager_read_data(int32_t *temperature, int32_t *humidity)
+{
+    if (temperature == NULL && humidity == NULL) {
+        ESP_LOGE(TAG, "Both temperature and humidity pointers are NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Start a single measurement, the sensor returns to sleep afterwards
+    esp_err_t status = write_register(BME280_REG_CTRL_MEAS, BME280_CTRL_MEAS_FORCED);
+    if (status != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start measurement: %s", esp_err_to_name(status));
+        return status;
+    }
+
+    vTaskDelay(BME280_MEASUREMENT_TICKS);
+
+    uint8_t data[8];
+    status = read_registers(BME280_REG_DATA, data, sizeof(data));
+    if (status != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read measurement: %s", esp_err_to_name(status));
+        return status;
+    }
+
+    int32_t adc_T = (int32_t)data[3] << 12 | (int32_t)data[4] << 4 | data[5] >> 4;
+    int32_t adc_H = (int32_t)data[6] << 8 | data[7];
+    if (adc_T == 0x80000) {
+        // Temperature measurement skipped, sensor reset since init
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    int32_t t_fine;
+    int32_t centi = compensate_temperature(adc_T, &t_fine);
+    // Q22.10 %RH to 0.1 %RH, rounded
+    int32_t permille = (int32_t)((compensate_humidity(adc_H, t_fine) * 10 + 512) >> 10);
+
+    if (temperature) {
+        *temperature = centi;
+    }
+    if (humidity) {
+        *humidity = permille;
+    }
+
+    char temperature_str[12];
+    char humidity_str[12];
+    format_fixed(temperature_str, sizeof(temperature_str), centi, 2);
+    format_fixed(humidity_str, sizeof(humidity_str), permille, 1);
+    ESP_LOGD(TAG, "Temperature: %s°C, Humidity: %s%%", temperature_str, humidity_str);
+
+    return ESP_OK;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Detect a BME280 sensor on the shared I2C bus and load its calibration
+ *
+ * Tries addresses 0x76 and 0x77. The I2C bus manager must be initialized.
+ *
+ * @return ESP_OK if a sensor was found, ESP_ERR_NOT_FOUND otherwise
+ */
+esp_err_t bme280_manager_init(void);
+
+/**
+ * @brief Check if a BME280 sensor was found
+ *
+ * @return true if bme280_manager_init() found a sensor
+ */
+bool bme280_manager_is_present(void);
+
+/**
+ * @brief Read temperature and humidity (forced mode, 1x oversampling)
+ *
+ * Takes about 10 ms. Uses the integer compensation of the datasheet,
+ * pressure is not measured.
+ *
+ * @param temperature Pointer to store the temperature value in 0.01 °C
+ * @param humidity Pointer to store the humidity value in 0.1 %RH (per-mille)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t bme280_manager_read_data(int32_t *temperature, int32_t *humidity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "boot_sequence.h"
+
+static const char *TAG = "boot_sequence";
+
+#define BOOT_STEP_STACK_SIZE 4096
+
+/**
+ * @brief Context of one step task
+ */
+typedef struct {
+    const boot_step_t *step;
+    boot_phase_t *phase;
+    uint32_t bit;
+} boot_task_ctx_t;
+
+static boot_task_ctx_t contexts[BOOT_SEQUENCE_MAX_STEPS];
+static EventGroupHandle_t done_group = NULL;
+static uint32_t failed_mask = 0;
+static portMUX_TYPE failed_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t boot_time_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Step task: wait for the dependencies, run the step, signal completion
+ */
+static void boot_step_task(void *arg)
+{
+    boot_task_ctx_t *ctx = (boot_task_ctx_t *)arg;
+    uint32_t depends = ctx->step->depends;
+
+    if (depends) {
+        xEventGroupWaitBits(done_group, depends, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    ctx->phase->start_ms = boot_time_ms();
+
+    taskENTER_CRITICAL(&failed_lock);
+    bool dependency_failed = (failed_mask & depends) != 0;
+    taskEXIT_CRITICAL(&failed_lock);
+
+    bool ok = false;
+    if (dependency_failed) {
+        ESP_LOGW(TAG, "Skipping %s, a dependency failed", ctx->step->name);
+    } else {
+        esp_err_t ret = ctx->step->run();
+        ok = ret == ESP_OK;
+        if (!ok) {
+            ESP_LOGW(TAG, "Step %s failed: %s", ctx->step->name, esp_err_to_name(ret));
+        }
+    }
+
+    ctx->phase->end_ms = boot_time_ms();
+    ctx->phase->ok = ok;
+
+    // Failure is recorded before the done bit, so dependents see it
+    if (!ok) {
+        taskENTER_CRITICAL(&failed_lock);
+        failed_mask |= ctx->bit;
+        taskEXIT_CRITICAL(&failed_lock);
+    }
+    xEventGroupSetBits(done_group, ctx->bit);
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_sequence_run(const boot_step_t *steps, size_t count, boot_phase_t *timeline)
+{
+    if (!steps || !timeline || count == 0 || count > BOOT_SEQUENCE_MAX_STEPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (steps[i].depends & ~(BOOT_DEP(i) - 1)) {
+            ESP_LOGE(TAG, "Step %s depends on a later step", steps[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    if (done_group == NULL) {
+        done_group = xEventGroupCreate();
+        if (done_group == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xEventGroupClearBits(done_group, BOOT_DEP(count) - 1);
+    failed_mask = 0;
+
+    uint32_t all = BOOT_DEP(count) - 1;
+    UBaseType_t priority = uxTaskPriorityGet(NULL);
+
+    for (size_t i = 0; i < count; i++) {
+        timeline[i] = (boot_phase_t) { 0 };
+
+        if (steps[i].run == NULL) {
+            xEventGroupSetBits(done_group, BOOT_DEP(i));
+            continue;
+        }
+
+        timeline[i].name = steps[i].name;
+        contexts[i] = (boot_task_ctx_t) {
+            .step = &steps[i],
+            .phase = &timeline[i],
+            .bit = BOOT_DEP(i),
+        };
+        if (xTaskCreate(boot_step_task, steps[i].name, BOOT_STEP_STACK_SIZE, &contexts[i], priority, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create task for step %s", steps[i].name);
+            // This and the later steps never run. Mark them failed and done, so the
+            // started steps that depend on them skip instead of waiting forever.
+            uint32_t not_started = all & ~(BOOT_DEP(i) - 1);
+            for (size_t j = i + 1; j < count; j++) {
+                timeline[j] = (boot_phase_t) { 0 };
+            }
+            taskENTER_CRITICAL(&failed_lock);
+            failed_mask |= not_started;
+            taskEXIT_CRITICAL(&failed_lock);
+            xEventGroupSetBits(done_group, not_started);
+            xEventGroupWaitBits(done_group, all, pdFALSE, pdTRUE, portMAX_DELAY);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xEventGroupWaitBits(done_group, all, pdFALSE, pdTRUE, portMAX_DELAY);
+
+    for (size_t i = 0; i < count; i++) {
+        if (timeline[i].name) {
+            ESP_LOGI(TAG, "%-12s %6" PRIu32 " .. %6" PRIu32 " ms %s", timeline[i].name,
+                     timeline[i].start_ms, timeline[i].end_ms, timeline[i].ok ? "ok" : "FAILED");
+        }
+    }
+
+    return failed_mask ? ESP_FAIL : ESP_OK;
+}
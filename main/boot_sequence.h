@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "messages/boot_phase.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of steps, one event group bit each
+#define BOOT_SEQUENCE_MAX_STEPS 24
+
+// Dependency mask of a step index
+#define BOOT_DEP(step) (1u << (step))
+
+/**
+ * @brief Init function of a boot step
+ */
+typedef esp_err_t (*boot_step_fn_t)(void);
+
+/**
+ * @brief Boot step, node of the init graph
+ */
+typedef struct {
+    const char *name;
+    boot_step_fn_t run;         // NULL to leave the step out
+    uint32_t depends;           // BOOT_DEP() mask of earlier steps that must succeed first
+} boot_step_t;
+
+/**
+ * @brief Run the init graph, steps without pending dependencies run concurrently
+ *
+ * Every step runs in its own task once all of its dependencies finished,
+ * so slow steps (network connect, sensor warm-up delays) overlap. A step
+ * whose dependency failed is not run and reported as failed. Dependencies
+ * may only name earlier steps, which keeps the graph acyclic.
+ *
+ * Blocks until all steps finished.
+ *
+ * @param steps    Steps, index = step id
+ * @param count    Number of steps (up to BOOT_SEQUENCE_MAX_STEPS)
+ * @param timeline Receives one phase per step (count entries)
+ * @return ESP_OK if all steps succeeded,
+ *         ESP_ERR_INVALID_ARG for an invalid graph,
+ *         ESP_ERR_NO_MEM if a step task could not be created,
+ *         ESP_FAIL if a step failed
+ */
+esp_err_t boot_sequence_run(const boot_step_t *steps, size_t count, boot_phase_t *timeline);
+
+#ifdef __cplusplus
+}
+#endif
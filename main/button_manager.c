@@ -1,162 +1,300 @@
 #include <stdio.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "trace_manager.h"
 #include "button_manager.h"
 
 static const char *TAG = "button_manager";
 
-// Debounce settings
-#define DEBOUNCE_TIME_MS 50
-#define LONG_PRESS_TIME_MS 2000
+// Timing settings
+#define DEBOUNCE_TIME_MS        CONFIG_BUTTON_DEBOUNCE_MS
+#define LONG_PRESS_TIME_MS      CONFIG_BUTTON_LONG_PRESS_MS
+#define DOUBLE_CLICK_TIME_MS    CONFIG_BUTTON_DOUBLE_CLICK_MS
 
-// Button state tracking
+/**
+ * @brief Message to the button task
+ */
+typedef enum {
+    BUTTON_MSG_EDGE,            // Edge interrupt, restart debouncing
+    BUTTON_MSG_DEBOUNCED,       // Debounce timer expired, level is stable
+    BUTTON_MSG_LONG_PRESS,      // Long-press timer expired
+} button_msg_type_t;
+
+typedef struct {
+    uint8_t button;             // Index in buttons[]
+    uint8_t type;               // button_msg_type_t
+    int64_t time_us;            // Time of the edge (BUTTON_MSG_EDGE only)
+} button_msg_t;
+
+// Button state tracking, owned by the button task
 typedef struct {
     gpio_num_t gpio;
-    bool last_state;
-    TickType_t press_time;
+    bool pressed;                       // Debounced state
     bool long_press_triggered;
+    int64_t edge_time_us;               // First edge of the current bounce burst, 0 if none
+    int64_t press_time_us;              // Last debounced press
+    int64_t click_time_us;              // Press of the last short click, 0 if none
+    esp_timer_handle_t debounce_timer;
+    esp_timer_handle_t long_press_timer;
 } button_state_t;
 
-static button_state_t buttons[2];
+static button_state_t buttons[BUTTON_MANAGER_MAX_BUTTONS];
+static size_t button_count = 0;
 static button_callback_t user_callback = NULL;
 static QueueHandle_t button_event_queue = NULL;
 static TaskHandle_t button_task_handle = NULL;
 
+static button_latency_stats_t latency_stats = { .min_us = UINT32_MAX };
+static uint64_t latency_sum_us = 0;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /**
  * @brief ISR handler for button interrupts
+ *
+ * Interrupts are level triggered, as only levels wake the chip from light
+ * sleep. Re-arming for the opposite level turns them into edge interrupts.
+ * The driver calls for that are neither in IRAM nor ISR safe, the inline
+ * LL functions write the pin registers directly.
  */
 static void IRAM_ATTR button_isr_handler(void *arg)
 {
-    gpio_num_t gpio = (gpio_num_t)(int)arg;
-    xQueueSendFromISR(button_event_queue, &gpio, NULL);
+    uint8_t index = (uint8_t)(uintptr_t)arg;
+    gpio_num_t gpio = buttons[index].gpio;
+    gpio_dev_t *hw = GPIO_LL_GET_HW(GPIO_PORT_0);
+    gpio_ll_set_intr_type(hw, gpio, gpio_ll_get_level(hw, gpio) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_ll_wakeup_enable(hw, gpio);
+    TRACE(TRACE_EVENT_BUTTON_EDGE, index, 0);
+
+    button_msg_t msg = {
+        .button = index,
+        .type = BUTTON_MSG_EDGE,
+        .time_us = esp_timer_get_time(),
+    };
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(button_event_queue, &msg, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief esp_timer callback, forwards the expired timer to the button task
+ */
+static void button_timer_callback(void *arg)
+{
+    uintptr_t value = (uintptr_t)arg;
+    button_msg_t msg = {
+        .button = (uint8_t)(value >> 8),
+        .type = (uint8_t)(value & 0xFF),
+    };
+    if (xQueueSend(button_event_queue, &msg, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Button queue full, timer event dropped");
+    }
+}
+
+static void record_latency(int64_t edge_time_us)
+{
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - edge_time_us);
+
+    taskENTER_CRITICAL(&stats_lock);
+    latency_stats.count++;
+    latency_sum_us += latency;
+    latency_stats.avg_us = (uint32_t)(latency_sum_us / latency_stats.count);
+    if (latency < latency_stats.min_us) {
+        latency_stats.min_us = latency;
+    }
+    if (latency > latency_stats.max_us) {
+        latency_stats.max_us = latency;
+    }
+    taskEXIT_CRITICAL(&stats_lock);
+}
+
+static void notify(button_state_t *btn, button_event_t event)
+{
+    if (user_callback) {
+        user_callback(btn->gpio, event);
+    }
+}
+
+/**
+ * @brief Handle a debounced level of a button
+ */
+static void handle_debounced(button_state_t *btn)
+{
+    // Read current state (active HIGH - pressed = 1, inverted polarity)
+    bool pressed = gpio_get_level(btn->gpio) == 1;
+    int64_t edge_time_us = btn->edge_time_us;
+    btn->edge_time_us = 0;
+
+    if (pressed == btn->pressed) {
+        return;     // Glitch, level returned to the previous state
+    }
+    btn->pressed = pressed;
+
+    if (pressed) {
+        btn->press_time_us = edge_time_us;
+        btn->long_press_triggered = false;
+        esp_timer_start_once(btn->long_press_timer, (uint64_t)LONG_PRESS_TIME_MS * 1000);
+
+        ESP_LOGI(TAG, "Button GPIO %d pressed", btn->gpio);
+        record_latency(edge_time_us);
+        notify(btn, BUTTON_EVENT_PRESSED);
+
+        // Second short click within the window
+        if (btn->click_time_us != 0 &&
+            edge_time_us - btn->click_time_us <= (int64_t)DOUBLE_CLICK_TIME_MS * 1000) {
+            btn->click_time_us = 0;
+            ESP_LOGI(TAG, "Button GPIO %d double click", btn->gpio);
+            notify(btn, BUTTON_EVENT_DOUBLE_CLICK);
+        } else {
+            btn->click_time_us = edge_time_us;
+        }
+    } else {
+        esp_timer_stop(btn->long_press_timer);
+        if (btn->long_press_triggered) {
+            btn->click_time_us = 0;     // A long press does not start a double click
+        }
+
+        uint32_t press_duration_ms = (uint32_t)((edge_time_us - btn->press_time_us) / 1000);
+        ESP_LOGI(TAG, "Button GPIO %d released (held for %lu ms)", btn->gpio, press_duration_ms);
+        record_latency(edge_time_us);
+        notify(btn, BUTTON_EVENT_RELEASED);
+    }
 }
 
 /**
  * @brief Task to handle button events
+ *
+ * Never blocks on a single button: edges only (re)start the per-button
+ * debounce timer, the level is sampled once the timer expires.
  */
 static void button_task(void *arg)
 {
-    gpio_num_t gpio;
-    
+    button_msg_t msg;
+
     while (1) {
-        if (xQueueReceive(button_event_queue, &gpio, portMAX_DELAY)) {
-            // Find button state
-            button_state_t *btn = NULL;
-            for (int i = 0; i < 2; i++) {
-                if (buttons[i].gpio == gpio) {
-                    btn = &buttons[i];
-                    break;
+        if (xQueueReceive(button_event_queue, &msg, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (msg.button >= button_count) {
+            continue;
+        }
+
+        button_state_t *btn = &buttons[msg.button];
+
+        switch (msg.type) {
+            case BUTTON_MSG_EDGE:
+                if (btn->edge_time_us == 0) {
+                    btn->edge_time_us = msg.time_us;
                 }
-            }
-            
-            if (btn == NULL) continue;
-            
-            // Debounce delay
-            vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_TIME_MS));
-            
-            // Read current state (active HIGH - pressed = 1, inverted polarity)
-            int level = gpio_get_level(gpio);
-            bool pressed = (level == 1);
-            
-            // Check if state changed
-            if (pressed != btn->last_state) {
-                btn->last_state = pressed;
-                
-                if (pressed) {
-                    // Button pressed
-                    btn->press_time = xTaskGetTickCount();
-                    btn->long_press_triggered = false;
-                    
-                    ESP_LOGI(TAG, "Button GPIO %d pressed", gpio);
-                    
-                    if (user_callback) {
-                        user_callback(gpio, BUTTON_EVENT_PRESSED);
-                    }
-                } else {
-                    // Button released
-                    TickType_t press_duration = xTaskGetTickCount() - btn->press_time;
-                    uint32_t press_duration_ms = press_duration * portTICK_PERIOD_MS;
-                    
-                    ESP_LOGI(TAG, "Button GPIO %d released (held for %lu ms)", gpio, press_duration_ms);
-                    
-                    if (user_callback) {
-                        user_callback(gpio, BUTTON_EVENT_RELEASED);
-                    }
+                esp_timer_stop(btn->debounce_timer);
+                esp_timer_start_once(btn->debounce_timer, (uint64_t)DEBOUNCE_TIME_MS * 1000);
+                break;
+
+            case BUTTON_MSG_DEBOUNCED:
+                if (btn->edge_time_us != 0) {
+                    handle_debounced(btn);
                 }
-            }
-            
-            // Check for long press (while button is still held)
-            if (pressed && !btn->long_press_triggered) {
-                TickType_t current_time = xTaskGetTickCount();
-                TickType_t press_duration = current_time - btn->press_time;
-                uint32_t press_duration_ms = press_duration * portTICK_PERIOD_MS;
-                
-                if (press_duration_ms >= LONG_PRESS_TIME_MS) {
+                break;
+
+            case BUTTON_MSG_LONG_PRESS:
+                // Held for the whole time, fire without waiting for the release
+                if (btn->pressed && !btn->long_press_triggered) {
                     btn->long_press_triggered = true;
-                    ESP_LOGI(TAG, "Button GPIO %d long press detected", gpio);
-                    
-                    if (user_callback) {
-                        user_callback(gpio, BUTTON_EVENT_LONG_PRESS);
-                    }
+                    ESP_LOGI(TAG, "Button GPIO %d long press detected", btn->gpio);
+                    notify(btn, BUTTON_EVENT_LONG_PRESS);
                 }
-            }
+                break;
         }
     }
 }
 
-esp_err_t button_manager_init(button_callback_t callback)
+static esp_err_t create_timer(size_t index, button_msg_type_t type, const char *name, esp_timer_handle_t *timer)
+{
+    const esp_timer_create_args_t args = {
+        .callback = button_timer_callback,
+        .arg = (void *)(uintptr_t)((index << 8) | type),
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = name,
+    };
+    return esp_timer_create(&args, timer);
+}
+
+esp_err_t button_manager_init(const gpio_num_t *gpios, size_t count, button_callback_t callback)
 {
     ESP_LOGI(TAG, "Initializing button manager");
-    
+
+    if (gpios == NULL || count == 0 || count > BUTTON_MANAGER_MAX_BUTTONS) {
+        ESP_LOGE(TAG, "Invalid button table (%u buttons)", (unsigned)count);
+        return ESP_ERR_INVALID_ARG;
+    }
+
     user_callback = callback;
-    
-    // Initialize button states
-    buttons[0].gpio = CONFIG_BUTTON0_GPIO;
-    buttons[0].last_state = false; // Not pressed (inverted - LOW when not pressed)
-    buttons[0].press_time = 0;
-    buttons[0].long_press_triggered = false;
-    
-    buttons[1].gpio = CONFIG_BUTTON1_GPIO;
-    buttons[1].last_state = false; // Not pressed (inverted - LOW when not pressed)
-    buttons[1].press_time = 0;
-    buttons[1].long_press_triggered = false;
-    
-    // Create event queue
-    button_event_queue = xQueueCreate(10, sizeof(gpio_num_t));
+
+    // Create event queue, room for a bounce burst on every button
+    button_event_queue = xQueueCreate(8 * count, sizeof(button_msg_t));
     if (button_event_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create button event queue");
         return ESP_ERR_NO_MEM;
     }
-    
+
     // Configure GPIO for buttons (inverted polarity - pull-down, active HIGH)
     gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << CONFIG_BUTTON0_GPIO) | (1ULL << CONFIG_BUTTON1_GPIO),
+        .pin_bit_mask = 0,
         .mode = GPIO_MODE_INPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_ENABLE,   // Pull-down for inverted polarity
-        .intr_type = GPIO_INTR_ANYEDGE,         // Trigger on both edges
+        .intr_type = GPIO_INTR_HIGH_LEVEL,      // Wait for a press, flipped in the ISR
     };
-    
+
+    // Initialize button states
+    for (size_t i = 0; i < count; i++) {
+        button_state_t *btn = &buttons[i];
+        btn->gpio = gpios[i];
+        btn->pressed = false;   // Not pressed (inverted - LOW when not pressed)
+        btn->long_press_triggered = false;
+        btn->edge_time_us = 0;
+        btn->press_time_us = 0;
+        btn->click_time_us = 0;
+
+        esp_err_t ret = create_timer(i, BUTTON_MSG_DEBOUNCED, "btn_debounce", &btn->debounce_timer);
+        if (ret == ESP_OK) {
+            ret = create_timer(i, BUTTON_MSG_LONG_PRESS, "btn_long", &btn->long_press_timer);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create button timers: %s", esp_err_to_name(ret));
+            return ret;
+        }
+
+        io_conf.pin_bit_mask |= 1ULL << gpios[i];
+    }
+    button_count = count;
+
     esp_err_t ret = gpio_config(&io_conf);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to configure GPIO: %s", esp_err_to_name(ret));
         return ret;
     }
-    
+
     // Install GPIO ISR service
     ret = gpio_install_isr_service(0);
     if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
         ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
         return ret;
     }
-    
-    // Add ISR handlers for both buttons
-    gpio_isr_handler_add(CONFIG_BUTTON0_GPIO, button_isr_handler, (void *)CONFIG_BUTTON0_GPIO);
-    gpio_isr_handler_add(CONFIG_BUTTON1_GPIO, button_isr_handler, (void *)CONFIG_BUTTON1_GPIO);
-    
+
+    // Add ISR handlers, the argument is the button index. A level change
+    // also wakes the chip from automatic light sleep.
+    for (size_t i = 0; i < count; i++) {
+        gpio_isr_handler_add(gpios[i], button_isr_handler, (void *)(uintptr_t)i);
+        gpio_wakeup_enable(gpios[i], GPIO_INTR_HIGH_LEVEL);
+    }
+    esp_sleep_enable_gpio_wakeup();
+
     // Create button handling task (increased stack size for display operations)
     BaseType_t task_created = xTaskCreate(
         button_task,
@@ -166,13 +304,13 @@ esp_err_t button_manager_init(button_callback_t callback)
         5,
         &button_task_handle
     );
-    
+
     if (task_created != pdPASS) {
         ESP_LOGE(TAG, "Failed to create button task");
         return ESP_FAIL;
     }
-    
-    ESP_LOGI(TAG, "Button manager initialized (GPIO %d and %d)", CONFIG_BUTTON0_GPIO, CONFIG_BUTTON1_GPIO);
+
+    ESP_LOGI(TAG, "Button manager initialized (%u buttons)", (unsigned)count);
     return ESP_OK;
 }
 
@@ -185,3 +323,14 @@ gpio_num_t button_manager_get_button1_gpio(void)
 {
     return (gpio_num_t)CONFIG_BUTTON1_GPIO;
 }
+
+void button_manager_get_latency_stats(button_latency_stats_t *stats)
+{
+    taskENTER_CRITICAL(&stats_lock);
+    *stats = latency_stats;
+    taskEXIT_CRITICAL(&stats_lock);
+
+    if (stats->count == 0) {
+        stats->min_us = 0;
+    }
+}
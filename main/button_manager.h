@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "driver/gpio.h"
 
@@ -7,6 +9,9 @@
 extern "C" {
 #endif
 
+// Maximum number of buttons handled by the button manager
+#define BUTTON_MANAGER_MAX_BUTTONS 8
+
 /**
  * @brief Button event types
  */
@@ -14,23 +19,42 @@ typedef enum {
     BUTTON_EVENT_PRESSED,
     BUTTON_EVENT_RELEASED,
     BUTTON_EVENT_LONG_PRESS,
+    BUTTON_EVENT_DOUBLE_CLICK,
 } button_event_t;
 
 /**
  * @brief Button callback function type
- * 
+ *
  * @param gpio GPIO number of the button
  * @param event Type of button event
  */
 typedef void (*button_callback_t)(gpio_num_t gpio, button_event_t event);
 
+/**
+ * @brief Latency from the first edge interrupt to the event callback
+ *
+ * Includes the debounce time, press and release events only.
+ */
+typedef struct {
+    uint32_t count;         // Number of measured events
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+} button_latency_stats_t;
+
 /**
  * @brief Initialize button manager
- * 
+ *
+ * Buttons are active high with internal pull-downs. Each button has its own
+ * debounce and long-press timer, so a bouncing or held button never delays
+ * the others. Callbacks are called from the button task.
+ *
+ * @param gpios    GPIO numbers of the buttons
+ * @param count    Number of buttons (up to BUTTON_MANAGER_MAX_BUTTONS)
  * @param callback Function to call when button event occurs
- * @return ESP_OK on success
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad button table
  */
-esp_err_t button_manager_init(button_callback_t callback);
+esp_err_t button_manager_init(const gpio_num_t *gpios, size_t count, button_callback_t callback);
 
 /**
  * @brief Get button 0 GPIO number
@@ -42,6 +66,13 @@ gpio_num_t button_manager_get_button0_gpio(void);
  */
 gpio_num_t button_manager_get_button1_gpio(void);
 
+/**
+ * @brief Get the interrupt to event latency statistics
+ *
+ * @param stats Destination of the statistics
+ */
+void button_manager_get_latency_stats(button_latency_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
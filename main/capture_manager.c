@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "capture_manager.h"
+
+static const char *const source_names[CAPTURE_SOURCE_COUNT] = {
+    [CAPTURE_SOURCE_DS18B20] = "ds18b20",
+    [CAPTURE_SOURCE_DHT22] = "dht22",
+    [CAPTURE_SOURCE_ADC] = "adc",
+};
+
+const char *capture_manager_source_name(capture_source_t source)
+{
+    return source < CAPTURE_SOURCE_COUNT ? source_names[source] : "unknown";
+}
+
+#if CONFIG_CAPTURE_ENABLE
+
+static const char *TAG = "capture_manager";
+
+#define CAPTURE_LINE_SIZE   64      // "CAP1 4294967295 ds18b20 -2147483648 -2147483648 -2147483648\n"
+
+static char batch[CONFIG_CAPTURE_BATCH_SIZE];
+static size_t batch_len = 0;
+static capture_clock_t clock_ms = NULL;
+static capture_output_t output_fn = NULL;
+static void *output_ctx = NULL;
+
+// Reads come from the sampling task, flushes also from the main task
+static SemaphoreHandle_t batch_lock = NULL;
+static StaticSemaphore_t batch_lock_buffer;
+
+esp_err_t capture_manager_init(capture_clock_t clock, capture_output_t output, void *ctx)
+{
+    if (batch_lock == NULL) {
+        batch_lock = xSemaphoreCreateMutexStatic(&batch_lock_buffer);
+    }
+
+    xSemaphoreTake(batch_lock, portMAX_DELAY);
+    clock_ms = clock;
+    output_fn = output;
+    output_ctx = ctx;
+    batch_len = 0;
+    xSemaphoreGive(batch_lock);
+
+    ESP_LOGI(TAG, "Capturing sensor reads, batches of %d bytes", CONFIG_CAPTURE_BATCH_SIZE);
+    return ESP_OK;
+}
+
+/* Caller holds batch_lock */
+static void send_batch(void)
+{
+    if (batch_len > 0) {
+        batch[batch_len] = '\0';
+        output_fn(batch, output_ctx);
+        batch_len = 0;
+    }
+}
+
+void capture_manager_record(capture_source_t source, esp_err_t status, int32_t raw0, int32_t raw1)
+{
+    if (batch_lock == NULL || output_fn == NULL) {
+        return;
+    }
+
+    char line[CAPTURE_LINE_SIZE];
+    int len = snprintf(line, sizeof(line), "CAP1 %" PRIu32 " %s %d %" PRId32 " %" PRId32 "\n", clock_ms(),
+                       capture_manager_source_name(source), status, raw0, raw1);
+    if (len <= 0 || len >= (int)sizeof(line)) {
+        return;
+    }
+
+    xSemaphoreTake(batch_lock, portMAX_DELAY);
+    // One byte stays free for the terminating NUL
+    if (batch_len + (size_t)len >= sizeof(batch)) {
+        send_batch();
+    }
+    memcpy(&batch[batch_len], line, (size_t)len);
+    batch_len += (size_t)len;
+    xSemaphoreGive(batch_lock);
+}
+
+void capture_manager_flush(void)
+{
+    if (batch_lock == NULL || output_fn == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(batch_lock, portMAX_DELAY);
+    send_batch();
+    xSemaphoreGive(batch_lock);
+}
+
+#else
+
+esp_err_t capture_manager_init(capture_clock_t clock, capture_output_t output, void *ctx)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void capture_manager_record(capture_source_t source, esp_err_t status, int32_t raw0, int32_t raw1)
+{
+}
+
+void capture_manager_flush(void)
+{
+}
+
+#endif
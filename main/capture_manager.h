@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Captured sensor reads
+ *
+ * Names are part of the capture format, see capture_manager_record().
+ */
+typedef enum {
+    CAPTURE_SOURCE_DS18B20 = 0,     // raw0 = scratchpad temperature (1/16 °C), raw1 = device index
+    CAPTURE_SOURCE_DHT22,           // raw0 = temperature (0.1 °C), raw1 = humidity (0.1 %RH)
+    CAPTURE_SOURCE_ADC,             // raw0 = ADC code, raw1 = calibrated pin voltage (mV)
+    CAPTURE_SOURCE_COUNT
+} capture_source_t;
+
+/**
+ * @brief Time source of the capture timestamps in ms
+ */
+typedef uint32_t (*capture_clock_t)(void);
+
+/**
+ * @brief Receives a batch of capture lines, NUL-terminated, every line ends with a line break
+ */
+typedef void (*capture_output_t)(const char *lines, void *ctx);
+
+/**
+ * @brief Start capturing
+ *
+ * Reads recorded before are dropped.
+ *
+ * @param clock  Time source, the one of the sample pipeline
+ * @param output Receives the batches, e.g. publishes them
+ * @param ctx    Passed to output
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED without CONFIG_CAPTURE_ENABLE
+ */
+esp_err_t capture_manager_init(capture_clock_t clock, capture_output_t output, void *ctx);
+
+/**
+ * @brief Record one sensor read
+ *
+ * Formats the line
+ *
+ *     CAP1 <ms> <source> <status> <raw0> <raw1>
+ *
+ * with the source name and the esp_err_t of the read, and queues it in
+ * the current batch. Full batches go to the output, so call from tasks
+ * only. Use the CAPTURE() macro, which compiles to nothing without
+ * CONFIG_CAPTURE_ENABLE.
+ *
+ * @param source Sensor that was read
+ * @param status Result of the driver read, raw values are undefined if not ESP_OK
+ * @param raw0   First raw value, see capture_source_t
+ * @param raw1   Second raw value, see capture_source_t
+ */
+void capture_manager_record(capture_source_t source, esp_err_t status, int32_t raw0, int32_t raw1);
+
+#if CONFIG_CAPTURE_ENABLE
+#define CAPTURE(source, status, raw0, raw1) capture_manager_record((source), (status), (raw0), (raw1))
+#else
+#define CAPTURE(source, status, raw0, raw1) ((void)0)
+#endif
+
+/**
+ * @brief Send the lines of the current batch, e.g. before deep sleep
+ */
+void capture_manager_flush(void);
+
+/**
+ * @brief Name of a source as written in the capture lines
+ */
+const char *capture_manager_source_name(capture_source_t source);
+
+#ifdef __cplusplus
+}
+#endif
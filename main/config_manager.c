@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "messages/command_parser.h"
+#include "messages/fixed_point.h"
+#include "power_manager.h"
+#include "config_manager.h"
+
+static const char *TAG = "config_manager";
+
+#define CONFIG_NVS_NAMESPACE    "app_cfg"
+#define CONFIG_NVS_KEY          "cfg"
+#define CONFIG_BLOB_VERSION     3
+
+// Limits accepted from remote commands
+#define SAMPLE_PERIOD_MIN_MS    1000
+#define SAMPLE_PERIOD_MAX_MS    3600000
+
+// Stored blob, versioned. New fields are only ever appended to app_config_t,
+// so an older blob is a valid prefix and the rest is taken from defaults.
+typedef struct {
+    uint32_t version;
+    app_config_t config;
+} config_blob_t;
+
+// Bytes of app_config_t valid in each stored version (index = version)
+static const size_t config_version_size[CONFIG_BLOB_VERSION + 1] = {
+    [1] = offsetof(app_config_t, adaptive_sampling),
+    [2] = offsetof(app_config_t, power_profile),
+    [3] = sizeof(app_config_t),
+};
+
+static const char *const log_level_names[] = {
+    "none", "error", "warn", "info", "debug", "verbose",
+};
+
+static app_config_t current_config;
+static SemaphoreHandle_t config_mutex = NULL;
+
+static void config_set_defaults(app_config_t *config)
+{
+    *config = (app_config_t) {
+        .sample_period_ms = CONFIG_SAMPLE_PERIOD_MS,
+        .heartbeat_cycles = 6,
+        .temp_deadband = 0,
+        .humidity_deadband = 0,
+        .voltage_deadband_mv = 0,
+        .publish_qos = 1,
+        .publish_retain = false,
+        .log_level = ESP_LOG_INFO,
+        .adaptive_sampling = CONFIG_SAMPLE_ADAPTIVE_DEFAULT,
+        .power_profile = CONFIG_POWER_PROFILE_DEFAULT,
+    };
+}
+
+static void config_apply(const app_config_t *config)
+{
+    static bool power_applied = false;
+
+    esp_log_level_set("*", (esp_log_level_t)config->log_level);
+
+    if (!power_applied || config->power_profile != power_manager_get_profile()) {
+        power_applied = power_manager_apply((power_profile_t)config->power_profile) == ESP_OK;
+    }
+}
+
+static esp_err_t config_load(app_config_t *config)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CONFIG_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    config_blob_t blob;
+    size_t size = sizeof(blob);
+    ret = nvs_get_blob(handle, CONFIG_NVS_KEY, &blob, &size);
+    nvs_close(handle);
+
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (size < offsetof(config_blob_t, config) || blob.version == 0 || blob.version > CONFIG_BLOB_VERSION ||
+        size - offsetof(config_blob_t, config) < config_version_size[blob.version]) {
+        ESP_LOGW(TAG, "Stored configuration has incompatible layout, ignoring");
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    config_set_defaults(config);
+    memcpy(config, &blob.config, config_version_size[blob.version]);
+    if (blob.version != CONFIG_BLOB_VERSION) {
+        ESP_LOGI(TAG, "Upgraded stored configuration from version %" PRIu32, blob.version);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t config_store(const app_config_t *config)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(CONFIG_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    config_blob_t blob = {
+        .version = CONFIG_BLOB_VERSION,
+        .config = *config,
+    };
+
+    ret = nvs_set_blob(handle, CONFIG_NVS_KEY, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store configuration: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+static void config_format(const app_config_t *config, char *out, size_t size)
+{
+    char db_temp[16];
+    char db_hum[16];
+
+    format_fixed(db_temp, sizeof(db_temp), config->temp_deadband, 2);
+    format_fixed(db_hum, sizeof(db_hum), config->humidity_deadband, 1);
+
+    snprintf(out, size,
+             "period=%" PRIu32 " heartbeat=%" PRIu32 " db_temp=%s db_hum=%s db_volt=%" PRId32
+             " qos=%u retain=%u log=%s adaptive=%u power=%s",
+             config->sample_period_ms, config->heartbeat_cycles, db_temp, db_hum,
+             config->voltage_deadband_mv, config->publish_qos, config->publish_retain ? 1 : 0,
+             config->log_level < sizeof(log_level_names) / sizeof(log_level_names[0])
+                 ? log_level_names[config->log_level] : "?",
+             config->adaptive_sampling ? 1 : 0,
+             power_manager_profile_name((power_profile_t)config->power_profile));
+}
+
+static bool parse_log_level(const command_token_t *token, uint8_t *level)
+{
+    for (size_t i = 0; i < sizeof(log_level_names) / sizeof(log_level_names[0]); i++) {
+        size_t len = strlen(log_level_names[i]);
+        if (token->value_len == len && memcmp(token->value, log_level_names[i], len) == 0) {
+            *level = (uint8_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Apply one token to the candidate configuration
+ *
+ * @return NULL on success, static error description otherwise
+ */
+static const char *config_apply_token(app_config_t *config, const command_token_t *token)
+{
+    uint32_t u = 0;
+    int32_t fixed = 0;
+
+    if (command_token_is(token, "get")) {
+        return NULL;
+    }
+    if (command_token_is(token, "reset")) {
+        config_set_defaults(config);
+        return NULL;
+    }
+
+    if (token->value == NULL) {
+        return "missing value";
+    }
+
+    if (command_token_is(token, "period")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) ||
+            u < SAMPLE_PERIOD_MIN_MS || u > SAMPLE_PERIOD_MAX_MS) {
+            return "out of range";
+        }
+        config->sample_period_ms = u;
+    } else if (command_token_is(token, "heartbeat")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) || u > 1000) {
+            return "out of range";
+        }
+        config->heartbeat_cycles = u;
+    } else if (command_token_is(token, "db_temp")) {
+        if (!command_parse_fixed(token->value, token->value_len, 2, &fixed) || fixed < 0 || fixed > 1000) {
+            return "out of range";
+        }
+        config->temp_deadband = fixed;
+    } else if (command_token_is(token, "db_hum")) {
+        if (!command_parse_fixed(token->value, token->value_len, 1, &fixed) || fixed < 0 || fixed > 1000) {
+            return "out of range";
+        }
+        config->humidity_deadband = fixed;
+    } else if (command_token_is(token, "db_volt")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) || u > 10000) {
+            return "out of range";
+        }
+        config->voltage_deadband_mv = (int32_t)u;
+    } else if (command_token_is(token, "qos")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) || u > 2) {
+            return "out of range";
+        }
+        config->publish_qos = (uint8_t)u;
+    } else if (command_token_is(token, "retain")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) || u > 1) {
+            return "out of range";
+        }
+        config->publish_retain = (u == 1);
+    } else if (command_token_is(token, "adaptive")) {
+        if (!command_parse_uint(token->value, token->value_len, &u) || u > 1) {
+            return "out of range";
+        }
+        config->adaptive_sampling = (u == 1);
+    } else if (command_token_is(token, "power")) {
+        power_profile_t profile;
+        if (!power_manager_parse_profile(token->value, token->value_len, &profile)) {
+            return "unknown profile";
+        }
+        config->power_profile = (uint8_t)profile;
+    } else if (command_token_is(token, "log")) {
+        if (!parse_log_level(token, &config->log_level)) {
+            return "unknown level";
+        }
+    } else {
+        return "unknown key";
+    }
+
+    return NULL;
+}
+
+esp_err_t config_manager_init(void)
+{
+    if (config_mutex == NULL) {
+        config_mutex = xSemaphoreCreateMutex();
+        if (config_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create config mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    app_config_t config;
+    esp_err_t ret = config_load(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGI(TAG, "No stored configuration (%s), using defaults", esp_err_to_name(ret));
+        config_set_defaults(&config);
+    }
+
+    xSemaphoreTake(config_mutex, portMAX_DELAY);
+    current_config = config;
+    xSemaphoreGive(config_mutex);
+
+    config_apply(&config);
+
+    char dump[160];
+    config_format(&config, dump, sizeof(dump));
+    ESP_LOGI(TAG, "Configuration: %s", dump);
+
+    return ESP_OK;
+}
+
+void config_manager_get(app_config_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    if (config_mutex == NULL) {
+        config_set_defaults(out);
+        return;
+    }
+
+    xSemaphoreTake(config_mutex, portMAX_DELAY);
+    *out = current_config;
+    xSemaphoreGive(config_mutex);
+}
+
+esp_err_t config_manager_handle_command(const char *payload, size_t len, char *resp, size_t resp_size)
+{
+    if (!payload || !resp || resp_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config_mutex == NULL) {
+        snprintf(resp, resp_size, "err not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    app_config_t candidate;
+    config_manager_get(&candidate);
+
+    // Request id echoed back so the sender can match the response
+    const char *id = "-";
+    int id_len = 1;
+
+    const char *cursor = payload;
+    const char *end = payload + len;
+    command_token_t token;
+    bool changed = false;
+
+    while (command_parser_next(&cursor, end, &token)) {
+        if (command_token_is(&token, "id") && token.value) {
+            id = token.value;
+            id_len = (int)token.value_len;
+            continue;
+        }
+
+        const char *error = config_apply_token(&candidate, &token);
+        if (error) {
+            snprintf(resp, resp_size, "err id=%.*s %.*s: %s",
+                     id_len, id, (int)token.key_len, token.key, error);
+            ESP_LOGW(TAG, "Rejected command: %s", resp);
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (!command_token_is(&token, "get")) {
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        esp_err_t ret = config_store(&candidate);
+        if (ret != ESP_OK) {
+            snprintf(resp, resp_size, "err id=%.*s store: %s", id_len, id, esp_err_to_name(ret));
+            return ret;
+        }
+
+        xSemaphoreTake(config_mutex, portMAX_DELAY);
+        current_config = candidate;
+        xSemaphoreGive(config_mutex);
+
+        config_apply(&candidate);
+    }
+
+    int written = snprintf(resp, resp_size, "ok id=%.*s ", id_len, id);
+    if (written > 0 && (size_t)written < resp_size) {
+        config_format(&candidate, resp + written, resp_size - (size_t)written);
+    }
+
+    if (changed) {
+        ESP_LOGI(TAG, "Configuration updated: %s", resp);
+    }
+
+    return ESP_OK;
+}
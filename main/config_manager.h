@@ -0,0 +1,75 @@
+#ifndef CONFIG_MANAGER_H
+#define CONFIG_MANAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Runtime configuration of the application
+ *
+ * Values are kept as integers in the units noted below so the command
+ * parser and the publish policy never need float math.
+ */
+typedef struct {
+    uint32_t sample_period_ms;      // Sampling loop period
+    uint32_t heartbeat_cycles;      // Publish unchanged values at least every N cycles (0 = every cycle)
+    int32_t temp_deadband;          // Temperature deadband in 0.01 °C (0 = publish every sample)
+    int32_t humidity_deadband;      // Humidity deadband in 0.1 %RH
+    int32_t voltage_deadband_mv;    // Voltage deadband in mV
+    uint8_t publish_qos;            // QoS of telemetry messages (0-2)
+    bool publish_retain;            // Retain flag of telemetry messages
+    uint8_t log_level;              // esp_log_level_t applied to all tags
+    bool adaptive_sampling;         // Adapt per-sensor rate to signal dynamics, sample_period_ms is the floor rate
+    uint8_t power_profile;          // power_profile_t
+} app_config_t;
+
+/**
+ * @brief Initialize the configuration manager
+ *
+ * Loads the stored configuration from NVS (NVS flash must already be
+ * initialized) or falls back to the Kconfig defaults, then applies it.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t config_manager_init(void);
+
+/**
+ * @brief Get a copy of the current configuration
+ *
+ * @param out Destination of the copy
+ */
+void config_manager_get(app_config_t *out);
+
+/**
+ * @brief Apply a text command to the configuration
+ *
+ * Parses a "key=value" command payload (see command_parser.h), validates
+ * all keys first and only then applies and persists the new configuration,
+ * so a command is either applied completely or not at all.
+ * Supported keys: period, heartbeat, db_temp, db_hum, db_volt, qos,
+ * retain, log, adaptive, power, plus the bare words "get" and "reset". An "id" key is
+ * echoed back in the response.
+ *
+ * Does not allocate memory.
+ *
+ * @param payload   Command payload (not NUL-terminated)
+ * @param len       Payload length
+ * @param resp      Buffer for the NUL-terminated response ("ok ..." or "err ...")
+ * @param resp_size Size of the response buffer
+ * @return ESP_OK if the command was applied,
+ *         ESP_ERR_INVALID_ARG on malformed command,
+ *         other error codes if the configuration could not be stored
+ */
+esp_err_t config_manager_handle_command(const char *payload, size_t len, char *resp, size_t resp_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_MANAGER_H
@@ -1,9 +1,13 @@
 #include <stdio.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "dht.h"
+#include "power_manager.h"
+#include "trace_manager.h"
+#include "capture_manager.h"
 #include "dht22_manager.h"
 
 static const char *TAG = "dht22_manager";
@@ -39,7 +43,7 @@ esp_err_t dht22_manager_init(void)
     return ESP_OK;
 }
 
-esp_err_t dht22_manager_read_data(float *temperature, float *humidity)
+esp_err_t dht22_manager_read_data(int32_t *temperature, int32_t *humidity)
 {
     if (temperature == NULL && humidity == NULL) {
         ESP_LOGE(TAG, "Both temperature and humidity pointers are NULL");
@@ -51,13 +55,20 @@ esp_err_t dht22_manager_read_data(float *temperature, float *humidity)
     TickType_t time_since_last_read = (current_time - last_read_time) * portTICK_PERIOD_MS;
     
     if (last_read_time != 0 && time_since_last_read < DHT22_MIN_INTERVAL_MS) {
-        ESP_LOGW(TAG, "Too soon to read again, wait %lu ms", 
-                 DHT22_MIN_INTERVAL_MS - time_since_last_read);
+        ESP_LOGW(TAG, "Too soon to read again, wait %" PRIu32 " ms",
+                 (uint32_t)(DHT22_MIN_INTERVAL_MS - time_since_last_read));
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Read data from DHT22 sensor
-    esp_err_t status = dht_read_float_data(DHT_TYPE_AM2301, CONFIG_DHT22_GPIO, humidity, temperature);
+    // Read data from DHT22 sensor (both values in tenths)
+    int16_t raw_humidity = 0;
+    int16_t raw_temperature = 0;
+    // Bit-banged protocol, keep the CPU at full clock for the transfer
+    TRACE(TRACE_EVENT_DHT22_READ_START, 0, 0);
+    power_manager_lock_timing();
+    esp_err_t status = dht_read_data(DHT_TYPE_AM2301, CONFIG_DHT22_GPIO, &raw_humidity, &raw_temperature);
+    power_manager_unlock_timing();
+    CAPTURE(CAPTURE_SOURCE_DHT22, status, raw_temperature, raw_humidity);
 
     if (status != ESP_OK) {
         ESP_LOGE(TAG, "Failed to read DHT22 sensor data: %s", esp_err_to_name(status));
@@ -67,8 +78,15 @@ esp_err_t dht22_manager_read_data(float *temperature, float *humidity)
     // Update last read time
     last_read_time = current_time;
     
-    // Log the readings
-    ESP_LOGI(TAG, "Temperature: %.1f°C, Humidity: %.1f%%", *temperature, *humidity);
+    if (temperature) {
+        *temperature = (int32_t)raw_temperature * 10;
+    }
+    if (humidity) {
+        *humidity = raw_humidity;
+    }
+
+    // Traced, formatting a log line on every read distorts the timing
+    TRACE(TRACE_EVENT_DHT22_READ_DONE, raw_temperature, raw_humidity);
     
     return ESP_OK;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include "esp_err.h"
 #include "driver/gpio.h"
 
@@ -17,11 +18,13 @@ esp_err_t dht22_manager_init(void);
 /**
  * @brief Read temperature and humidity from the DHT22 sensor
  * 
- * @param temperature Pointer to store the temperature value in Celsius
- * @param humidity Pointer to store the humidity value in percent
+ * Uses the integer API of the driver, no float math is involved.
+ * 
+ * @param temperature Pointer to store the temperature value in 0.01 °C
+ * @param humidity Pointer to store the humidity value in 0.1 %RH (per-mille)
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t dht22_manager_read_data(float *temperature, float *humidity);
+esp_err_t dht22_manager_read_data(int32_t *temperature, int32_t *humidity);
 
 /**
  * @brief Get the GPIO pin number used for DHT22
@@ -0,0 +1,195 @@
+#include <string.h>
+#include "ssd1306_fonts.h"
+#include "display_framebuffer.h"
+
+#define FONT_WIDTH  DISPLAY_FB_GLYPH_WIDTH
+#define FONT_HEIGHT 12
+
+// Framebuffer being drawn and copy of what the panel currently shows
+static uint8_t frame[DISPLAY_FB_PAGES][DISPLAY_FB_WIDTH];
+static uint8_t shadow[DISPLAY_FB_PAGES][DISPLAY_FB_WIDTH];
+static bool shadow_valid = false;
+
+#define FONT_FIRST_CHAR ' '
+#define FONT_GLYPHS     95
+#define FIXED_MAX_CHARS 12      // "-2147483.648" and shorter
+
+// Glyph columns with bit 0 as the top pixel, converted once from the MSB-first font
+static uint16_t glyph_cache[FONT_GLYPHS][FONT_WIDTH];
+
+static uint16_t label_pool[DISPLAY_FB_LABEL_POOL_COLUMNS];
+static size_t label_pool_used = 0;
+
+void display_fb_init(void)
+{
+    for (int c = 0; c < FONT_GLYPHS; c++) {
+        // Font stores each column as two bytes, MSB is the top pixel
+        const uint8_t *glyph = c_chFont1206[c];
+        for (int col = 0; col < FONT_WIDTH; col++) {
+            uint16_t bits = (uint16_t)glyph[2 * col] << 8 | glyph[2 * col + 1];
+            uint16_t column = 0;
+            for (int row = 0; row < FONT_HEIGHT; row++) {
+                if (bits & (0x8000u >> row)) {
+                    column |= (uint16_t)(1u << row);
+                }
+            }
+            glyph_cache[c][col] = column;
+        }
+    }
+}
+
+void display_fb_clear(void)
+{
+    memset(frame, 0, sizeof(frame));
+}
+
+/**
+ * @brief Overwrite FONT_HEIGHT rows of one column starting at row y
+ *
+ * The column spans at most three pages, each is updated with one
+ * read-modify-write instead of per-pixel work.
+ */
+static void blit_column(uint8_t x, uint8_t y, uint16_t bits)
+{
+    if (x >= DISPLAY_FB_WIDTH) {
+        return;
+    }
+
+    uint8_t shift = y % 8;
+    uint32_t mask = (uint32_t)((1u << FONT_HEIGHT) - 1) << shift;
+    uint32_t data = (uint32_t)bits << shift;
+
+    for (uint8_t page = y / 8; mask != 0 && page < DISPLAY_FB_PAGES; page++) {
+        frame[page][x] = (uint8_t)((frame[page][x] & ~mask) | (data & mask));
+        mask >>= 8;
+        data >>= 8;
+    }
+}
+
+static const uint16_t *glyph_columns(char c)
+{
+    if (c < FONT_FIRST_CHAR || c > '~') {
+        c = ' ';
+    }
+    return glyph_cache[c - FONT_FIRST_CHAR];
+}
+
+uint8_t display_fb_draw_string(uint8_t x, uint8_t y, const char *str)
+{
+    while (*str && x + FONT_WIDTH <= DISPLAY_FB_WIDTH) {
+        const uint16_t *columns = glyph_columns(*str++);
+        for (int col = 0; col < FONT_WIDTH; col++) {
+            blit_column((uint8_t)(x + col), y, columns[col]);
+        }
+        x += FONT_WIDTH;
+    }
+    return x;
+}
+
+uint8_t display_fb_draw_fixed(uint8_t x, uint8_t y, int32_t value, int decimals)
+{
+    char text[FIXED_MAX_CHARS + 1];
+    char *p = &text[FIXED_MAX_CHARS];
+    uint32_t abs_value = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+    // Build digits from the right, at least one digit before the point
+    *p = '\0';
+    for (int digits = 0; abs_value != 0 || digits <= decimals; digits++) {
+        if (digits == decimals && decimals > 0) {
+            *--p = '.';
+        }
+        *--p = (char)('0' + abs_value % 10);
+        abs_value /= 10;
+    }
+    if (value < 0) {
+        *--p = '-';
+    }
+
+    return display_fb_draw_string(x, y, p);
+}
+
+esp_err_t display_fb_label_render(display_fb_label_t *label, const char *str)
+{
+    size_t width = strlen(str) * FONT_WIDTH;
+    if (width > DISPLAY_FB_WIDTH - DISPLAY_FB_WIDTH % FONT_WIDTH) {
+        width = DISPLAY_FB_WIDTH - DISPLAY_FB_WIDTH % FONT_WIDTH;
+    }
+    if (label_pool_used + width > DISPLAY_FB_LABEL_POOL_COLUMNS) {
+        label->width = 0;
+        label->columns = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint16_t *columns = &label_pool[label_pool_used];
+    for (size_t col = 0; col < width; col += FONT_WIDTH) {
+        memcpy(&columns[col], glyph_columns(*str++), FONT_WIDTH * sizeof(uint16_t));
+    }
+
+    label_pool_used += width;
+    label->width = (uint8_t)width;
+    label->columns = columns;
+    return ESP_OK;
+}
+
+uint8_t display_fb_draw_label(uint8_t x, uint8_t y, const display_fb_label_t *label)
+{
+    for (uint8_t col = 0; col < label->width && x < DISPLAY_FB_WIDTH; col++, x++) {
+        blit_column(x, y, label->columns[col]);
+    }
+    return x;
+}
+
+void display_fb_draw_column(uint8_t x, uint8_t page, uint8_t pages, uint64_t bits)
+{
+    if (x >= DISPLAY_FB_WIDTH) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < pages && page + i < DISPLAY_FB_PAGES; i++) {
+        frame[page + i][x] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+void display_fb_invalidate(void)
+{
+    shadow_valid = false;
+}
+
+esp_err_t display_fb_flush(display_fb_write_t write, void *ctx)
+{
+    esp_err_t result = ESP_OK;
+
+    for (uint8_t page = 0; page < DISPLAY_FB_PAGES; page++) {
+        int first = 0;
+        int last = DISPLAY_FB_WIDTH - 1;
+
+        if (shadow_valid) {
+            while (first < DISPLAY_FB_WIDTH && frame[page][first] == shadow[page][first]) {
+                first++;
+            }
+            if (first == DISPLAY_FB_WIDTH) {
+                continue;
+            }
+            while (frame[page][last] == shadow[page][last]) {
+                last--;
+            }
+        }
+
+        size_t len = (size_t)(last - first + 1);
+        esp_err_t ret = write(page, (uint8_t)first, &frame[page][first], len, ctx);
+        if (ret != ESP_OK) {
+            if (result == ESP_OK) {
+                result = ret;
+            }
+            continue;
+        }
+        memcpy(&shadow[page][first], &frame[page][first], len);
+    }
+
+    // Until one flush went through completely every page is sent in full
+    if (result == ESP_OK) {
+        shadow_valid = true;
+    }
+
+    return result;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_FB_WIDTH  128
+#define DISPLAY_FB_HEIGHT 64
+#define DISPLAY_FB_PAGES  (DISPLAY_FB_HEIGHT / 8)
+
+// Width in pixels of one glyph of the 12 px font
+#define DISPLAY_FB_GLYPH_WIDTH 6
+
+// Glyph columns available for all pre-rendered labels together
+#define DISPLAY_FB_LABEL_POOL_COLUMNS 1152
+
+/**
+ * @brief Write a run of GRAM bytes to the panel
+ *
+ * @param page      Page (row of 8 pixels) of the run
+ * @param column    First column of the run
+ * @param data      Column bytes, bit 0 is the top pixel of the page
+ * @param len       Number of bytes
+ * @param ctx       User context passed to display_fb_flush()
+ * @return ESP_OK on success, the run is retried on the next flush otherwise
+ */
+typedef esp_err_t (*display_fb_write_t)(uint8_t page, uint8_t column, const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Text pre-rendered to glyph columns, blitted without per-glyph work
+ */
+typedef struct {
+    uint8_t width;              // Width in pixels
+    const uint16_t *columns;    // Column bits in the label pool, bit 0 is the top pixel
+} display_fb_label_t;
+
+/**
+ * @brief Build the glyph cache, call once before drawing
+ */
+void display_fb_init(void);
+
+/**
+ * @brief Clear the framebuffer
+ *
+ * Only the framebuffer is cleared, the panel keeps showing its content
+ * until the next display_fb_flush().
+ */
+void display_fb_clear(void);
+
+/**
+ * @brief Draw a string with the 12 px (6x12) font
+ *
+ * Each glyph overwrites its whole 6x12 cell. Text past the right edge is clipped.
+ *
+ * @param x   Left column
+ * @param y   Top row
+ * @param str NUL-terminated ASCII string
+ * @return Column after the last drawn glyph
+ */
+uint8_t display_fb_draw_string(uint8_t x, uint8_t y, const char *str);
+
+/**
+ * @brief Draw a fixed-point number with the 12 px font
+ *
+ * Digits are produced with integer division, without snprintf.
+ *
+ * @param x        Left column
+ * @param y        Top row
+ * @param value    Value scaled by 10^decimals
+ * @param decimals Number of fraction digits (0 for plain integers)
+ * @return Column after the last drawn glyph
+ */
+uint8_t display_fb_draw_fixed(uint8_t x, uint8_t y, int32_t value, int decimals);
+
+/**
+ * @brief Pre-render a static string into a label
+ *
+ * Labels are meant to be rendered once at init, their columns are taken
+ * from a static pool and never released.
+ *
+ * @param label Label to fill
+ * @param str   NUL-terminated ASCII string, clipped to the display width
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the label pool is exhausted
+ */
+esp_err_t display_fb_label_render(display_fb_label_t *label, const char *str);
+
+/**
+ * @brief Blit a pre-rendered label
+ *
+ * @param x     Left column
+ * @param y     Top row
+ * @param label Label from display_fb_label_render()
+ * @return Column after the label
+ */
+uint8_t display_fb_draw_label(uint8_t x, uint8_t y, const display_fb_label_t *label);
+
+/**
+ * @brief Overwrite a page-aligned column with a bitmap
+ *
+ * @param x     Column
+ * @param page  First page
+ * @param pages Number of pages (1-8)
+ * @param bits  Column bits, bit 0 is the top pixel of the first page
+ */
+void display_fb_draw_column(uint8_t x, uint8_t page, uint8_t pages, uint64_t bits);
+
+/**
+ * @brief Forget what the panel shows, the next flush sends the full frame
+ *
+ * Call after (re)initializing the panel.
+ */
+void display_fb_invalidate(void);
+
+/**
+ * @brief Send the parts of the framebuffer that differ from the panel
+ *
+ * The framebuffer is compared with a shadow copy of the panel GRAM. For
+ * every page only the column span between the first and the last changed
+ * byte is written.
+ *
+ * @param write Function writing one run of bytes
+ * @param ctx   User context passed to write
+ * @return ESP_OK if all changed spans were written, error of the first failed write otherwise
+ */
+esp_err_t display_fb_flush(display_fb_write_t write, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
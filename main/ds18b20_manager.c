@@ -1,20 +1,71 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "onewire_bus.h"
+#include "onewire_crc.h"
 #include "ds18b20.h"
+#include "power_manager.h"
+#include "capture_manager.h"
 #include "ds18b20_manager.h"
 
 static const char *TAG = "ds18b20_manager";
 
 #define ONEWIRE_MAX_DS18B20 2
 
+// 1-wire / DS18B20 commands used for the raw conversion and scratchpad transfers
+#define ONEWIRE_CMD_MATCH_ROM       0x55
+#define DS18B20_CMD_CONVERT_T       0x44
+#define DS18B20_CMD_READ_SCRATCHPAD 0xBE
+#define DS18B20_SCRATCHPAD_SIZE     9
+
+// Power-on resolution, conversion takes 93.75 ms at 9 bits and doubles per bit
+#define DS18B20_RESOLUTION_BITS     12
+#define DS18B20_CONVERSION_MS       (94 << (DS18B20_RESOLUTION_BITS - 9))
+
+// Round up and add one tick, vTaskDelay() may return up to a tick early
+#define DS18B20_CONVERSION_TICKS    ((DS18B20_CONVERSION_MS + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS + 1)
+
 static onewire_bus_handle_t bus = NULL;
 static int ds18b20_device_num = 0;
 static ds18b20_device_handle_t ds18b20s[ONEWIRE_MAX_DS18B20];
 
+// ROM codes of the found devices, kept across deep sleep to skip the bus search
+static RTC_DATA_ATTR onewire_device_address_t rom_cache[ONEWIRE_MAX_DS18B20];
+static RTC_DATA_ATTR int rom_cache_count = 0;
+
+/**
+ * @brief Create the device handles from the ROM codes cached before deep sleep
+ */
+static esp_err_t restore_devices(void)
+{
+    ds18b20_device_num = 0;
+
+    for (int i = 0; i < rom_cache_count; i++) {
+        onewire_device_t device = {
+            .bus = bus,
+            .address = rom_cache[i],
+        };
+        ds18b20_config_t ds18b20_cfg = {};
+
+        esp_err_t status = ds18b20_new_device_from_enumeration(&device, &ds18b20_cfg, &ds18b20s[i]);
+        if (status != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to restore DS18B20[%d], with error %s", i, esp_err_to_name(status));
+            while (ds18b20_device_num > 0) {
+                ds18b20_del_device(ds18b20s[--ds18b20_device_num]);
+            }
+            return status;
+        }
+        ds18b20_device_num++;
+    }
+
+    ESP_LOGI(TAG, "Restored %d DS18B20 device(s) from RTC memory", ds18b20_device_num);
+    return ESP_OK;
+}
+
 esp_err_t ds18b20_manager_init(void)
 {
     // install 1-wire bus
@@ -35,6 +86,11 @@ esp_err_t ds18b20_manager_init(void)
         return status;
     }
 
+    // After deep sleep the devices are known, skip the search
+    if (esp_reset_reason() == ESP_RST_DEEPSLEEP && rom_cache_count > 0 && restore_devices() == ESP_OK) {
+        return ESP_OK;
+    }
+
     status = ds18b20_manager_search_devices();
     if (status != ESP_OK) {
         ESP_LOGE(TAG, "Failed to search for DS18B20 devices, with error %s", esp_err_to_name(status));
@@ -85,8 +141,9 @@ esp_err_t ds18b20_manager_search_devices(void)
                 break;
             }
 
+            rom_cache[ds18b20_device_num] = address;
             ds18b20_device_num++;
-            ESP_LOGI(TAG, "Found a DS18B20[%d] with device address %016llX", ds18b20_device_num, address);
+            ESP_LOGI(TAG, "Found a DS18B20[%d] with device address %016" PRIX64, ds18b20_device_num, (uint64_t)address);
                 
             if (ds18b20_device_num >= ONEWIRE_MAX_DS18B20) {
                 ESP_LOGW(TAG, "Maximum number of DS18B20 devices reached");
@@ -101,12 +158,97 @@ esp_err_t ds18b20_manager_search_devices(void)
         ESP_LOGW(TAG, "Failed to delete device iterator, with error %s", esp_err_to_name(status));
     }
     
+    rom_cache_count = ds18b20_device_num;
     ESP_LOGI(TAG, "Searching done, %d DS18B20 device(s) found", ds18b20_device_num);
     
     return ESP_OK;
 }
 
-esp_err_t ds18b20_manager_read_temperature(int device_index, float *temperature)
+/**
+ * @brief Reset the bus, address a device and send a function command
+ */
+static esp_err_t send_command(int device_index, uint8_t command)
+{
+    onewire_device_address_t address;
+    esp_err_t status = ds18b20_get_device_address(ds18b20s[device_index], &address);
+    if (status != ESP_OK) {
+        return status;
+    }
+
+    status = onewire_bus_reset(bus);
+    if (status != ESP_OK) {
+        return status;
+    }
+
+    // MATCH ROM + 64-bit address (LSB first) + command
+    uint8_t tx[10];
+    tx[0] = ONEWIRE_CMD_MATCH_ROM;
+    for (int i = 0; i < 8; i++) {
+        tx[1 + i] = (uint8_t)(address >> (8 * i));
+    }
+    tx[9] = command;
+
+    return onewire_bus_write_bytes(bus, tx, sizeof(tx));
+}
+
+/**
+ * @brief Start a conversion, returns without waiting for it
+ *
+ * The conversion call of the ds18b20 component also waits the conversion
+ * time, which would keep the timing lock held across it.
+ */
+static esp_err_t trigger_conversion_locked(int device_index)
+{
+    power_manager_lock_timing();
+    esp_err_t status = send_command(device_index, DS18B20_CMD_CONVERT_T);
+    power_manager_unlock_timing();
+    return status;
+}
+
+/**
+ * @brief Read scratchpad of a device and return the raw temperature (1/16 °C)
+ */
+static esp_err_t read_raw_temperature(int device_index, int16_t *raw)
+{
+    esp_err_t status = send_command(device_index, DS18B20_CMD_READ_SCRATCHPAD);
+    if (status != ESP_OK) {
+        return status;
+    }
+
+    uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE];
+    status = onewire_bus_read_bytes(bus, scratchpad, sizeof(scratchpad));
+    if (status != ESP_OK) {
+        return status;
+    }
+
+    if (onewire_crc8(0, scratchpad, 8) != scratchpad[8]) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    *raw = (int16_t)((uint16_t)scratchpad[1] << 8 | scratchpad[0]);
+    return ESP_OK;
+}
+
+/**
+ * @brief Read the raw temperature with the bus timing held
+ */
+static esp_err_t read_raw_temperature_locked(int device_index, int16_t *raw)
+{
+    power_manager_lock_timing();
+    esp_err_t status = read_raw_temperature(device_index, raw);
+    power_manager_unlock_timing();
+    return status;
+}
+
+/**
+ * @brief Raw value is in 1/16 °C (12-bit resolution), 100/16 = 25/4
+ */
+static int32_t raw_to_centi(int16_t raw)
+{
+    return ((int32_t)raw * 25) / 4;
+}
+
+esp_err_t ds18b20_manager_read_temperature(int device_index, int32_t *temperature)
 {
     if (device_index >= ds18b20_device_num || device_index < 0) {
         ESP_LOGE(TAG, "Invalid device index %d", device_index);
@@ -118,21 +260,42 @@ esp_err_t ds18b20_manager_read_temperature(int device_index, float *temperature)
         return ESP_ERR_INVALID_ARG;
     }
     
-    esp_err_t status = ds18b20_trigger_temperature_conversion(ds18b20s[device_index]);
+    esp_err_t status = trigger_conversion_locked(device_index);
     if (status != ESP_OK) {
         ESP_LOGE(TAG, "Failed to trigger temperature conversion on device index %d, with error: %s", device_index, esp_err_to_name(status));
+        CAPTURE(CAPTURE_SOURCE_DS18B20, status, 0, device_index);
         return status;
     }
     
-    // Wait for conversion to complete
-    vTaskDelay(pdMS_TO_TICKS(1000)); // DS18B20 conversion time is up to 750ms
+    // Wait for conversion to complete, the CPU may sleep meanwhile
+    vTaskDelay(DS18B20_CONVERSION_TICKS);
     
-    status = ds18b20_get_temperature(ds18b20s[device_index], temperature);
+    int16_t raw = 0;
+    status = read_raw_temperature_locked(device_index, &raw);
+    CAPTURE(CAPTURE_SOURCE_DS18B20, status, raw, device_index);
     if (status != ESP_OK) {
         ESP_LOGE(TAG, "Failed to get temperature on device index %d, with error: %s", device_index, esp_err_to_name(status));
+        rom_cache_count = 0;    // Search the bus again after the next wake
         return status;
     }
     
+    *temperature = raw_to_centi(raw);
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_manager_read_scratchpad(int device_index, int32_t *temperature)
+{
+    if (device_index >= ds18b20_device_num || device_index < 0 || temperature == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int16_t raw = 0;
+    esp_err_t status = read_raw_temperature_locked(device_index, &raw);
+    if (status != ESP_OK) {
+        return status;
+    }
+
+    *temperature = raw_to_centi(raw);
     return ESP_OK;
 }
 
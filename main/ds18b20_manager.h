@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include "esp_err.h"
 #include "onewire_bus.h"
 
@@ -10,7 +11,9 @@ extern "C" {
 /**
  * @brief Initialize the DS18B20 manager
  * 
- * This function initializes the 1-wire bus and searches for DS18B20 devices
+ * This function initializes the 1-wire bus and searches for DS18B20 devices.
+ * After a wake from deep sleep the ROM codes found before are reused
+ * instead, a failed read drops them so the next boot searches again.
  * 
  * @return ESP_OK on success, error code otherwise
  */
@@ -26,11 +29,31 @@ esp_err_t ds18b20_manager_search_devices(void);
 /**
  * @brief Read temperature from a DS18B20 device
  * 
+ * Triggers a conversion, waits for it and reads the scratchpad directly,
+ * converting the raw 1/16 °C value with integer math only.
+ * 
  * @param device_index Index of the device (0 to device_count-1)
- * @param temperature Pointer to store the temperature value in Celsius
- * @return ESP_OK on success, error code otherwise
+ * @param temperature Pointer to store the temperature value in 0.01 °C
+ * @return ESP_OK on success,
+ *         ESP_ERR_INVALID_CRC if the scratchpad CRC does not match,
+ *         error code otherwise
+ */
+esp_err_t ds18b20_manager_read_temperature(int device_index, int32_t *temperature);
+
+/**
+ * @brief Read the last converted temperature without starting a conversion
+ * 
+ * A single MATCH ROM and READ SCRATCHPAD transaction, the 1-Wire bus time
+ * of a sample without the conversion wait. Returns the power-on value
+ * 85 °C if no conversion was done yet.
+ * 
+ * @param device_index Index of the device (0 to device_count-1)
+ * @param temperature Pointer to store the temperature value in 0.01 °C
+ * @return ESP_OK on success,
+ *         ESP_ERR_INVALID_CRC if the scratchpad CRC does not match,
+ *         error code otherwise
  */
-esp_err_t ds18b20_manager_read_temperature(int device_index, float *temperature);
+esp_err_t ds18b20_manager_read_scratchpad(int device_index, int32_t *temperature);
 
 /**
  * @brief Get the number of DS18B20 devices found
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "power_manager.h"
+#include "i2c_bus_manager.h"
+
+static const char *TAG = "i2c_bus_manager";
+
+#define I2C_BUS_PORT            I2C_NUM_0
+#define I2C_BUS_PROBE_TIMEOUT_MS 50
+#define I2C_BUS_QUEUE_LENGTH    8
+#define I2C_BUS_TRANS_DEPTH     10      /*!< Driver queue for asynchronous devices (display) */
+#define I2C_BUS_TASK_STACK_SIZE 3072
+#define I2C_BUS_TASK_PRIORITY   5
+
+/**
+ * @brief Queued transaction, lives on the stack of the waiting caller
+ */
+typedef struct {
+    i2c_master_dev_handle_t dev;
+    const uint8_t *tx;
+    size_t tx_len;
+    uint8_t *rx;
+    size_t rx_len;
+    int timeout_ms;
+    esp_err_t result;
+    SemaphoreHandle_t done;
+} i2c_bus_request_t;
+
+static i2c_master_bus_handle_t bus = NULL;
+static QueueHandle_t request_queue = NULL;
+
+// Outcome of the current bus task transaction, set by the completion callback
+static volatile i2c_master_event_t transfer_event = I2C_EVENT_ALIVE;
+
+/**
+ * @brief Transfer completion callback of the devices served by the bus task, runs in ISR context
+ *
+ * The bus is asynchronous for the display, so transmit and receive return
+ * once queued on every device and NACKs or timeouts only show up here.
+ */
+static bool IRAM_ATTR on_transfer_done(i2c_master_dev_handle_t dev, const i2c_master_event_data_t *evt, void *arg)
+{
+    transfer_event = evt->event;
+    return false;
+}
+
+static esp_err_t execute(const i2c_bus_request_t *req)
+{
+    esp_err_t ret;
+
+    transfer_event = I2C_EVENT_ALIVE;
+    if (req->tx_len > 0 && req->rx_len > 0) {
+        ret = i2c_master_transmit_receive(req->dev, req->tx, req->tx_len, req->rx, req->rx_len, req->timeout_ms);
+    } else if (req->tx_len > 0) {
+        ret = i2c_master_transmit(req->dev, req->tx, req->tx_len, req->timeout_ms);
+    } else {
+        ret = i2c_master_receive(req->dev, req->rx, req->rx_len, req->timeout_ms);
+    }
+
+    // Buffers belong to the caller, make sure the bus is done with them
+    if (ret == ESP_OK) {
+        ret = i2c_master_bus_wait_all_done(bus, req->timeout_ms);
+    }
+    if (ret == ESP_OK && transfer_event != I2C_EVENT_DONE) {
+        ret = transfer_event == I2C_EVENT_NACK ? ESP_FAIL : ESP_ERR_TIMEOUT;
+    }
+    return ret;
+}
+
+static void i2c_bus_task(void *arg)
+{
+    i2c_bus_request_t *req;
+
+    while (1) {
+        if (xQueueReceive(request_queue, &req, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        power_manager_lock_timing();
+        req->result = execute(req);
+        power_manager_unlock_timing();
+        if (req->result != ESP_OK) {
+            ESP_LOGD(TAG, "Transaction failed: %s", esp_err_to_name(req->result));
+        }
+        xSemaphoreGive(req->done);
+    }
+}
+
+esp_err_t i2c_bus_manager_init(void)
+{
+    if (bus != NULL) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Initializing I2C bus (SDA=GPIO%d, SCL=GPIO%d)", CONFIG_I2C_SDA_GPIO, CONFIG_I2C_SCL_GPIO);
+
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = I2C_BUS_PORT,
+        .sda_io_num = CONFIG_I2C_SDA_GPIO,
+        .scl_io_num = CONFIG_I2C_SCL_GPIO,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .trans_queue_depth = I2C_BUS_TRANS_DEPTH,
+        .flags.enable_internal_pullup = true,
+    };
+
+    esp_err_t ret = i2c_new_master_bus(&bus_config, &bus);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2C bus init failed: %s", esp_err_to_name(ret));
+        bus = NULL;
+        return ret;
+    }
+
+    request_queue = xQueueCreate(I2C_BUS_QUEUE_LENGTH, sizeof(i2c_bus_request_t *));
+    if (request_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create request queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t task_created = xTaskCreate(i2c_bus_task, "i2c_bus_task", I2C_BUS_TASK_STACK_SIZE,
+                                          NULL, I2C_BUS_TASK_PRIORITY, NULL);
+    if (task_created != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create bus task");
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+i2c_master_bus_handle_t i2c_bus_manager_get_bus(void)
+{
+    return bus;
+}
+
+esp_err_t i2c_bus_manager_add_device(uint16_t address, uint32_t scl_speed_hz, i2c_master_dev_handle_t *dev)
+{
+    if (bus == NULL || dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (i2c_master_probe(bus, address, I2C_BUS_PROBE_TIMEOUT_MS) != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = scl_speed_hz,
+    };
+    esp_err_t ret = i2c_master_bus_add_device(bus, &dev_config, dev);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to add device 0x%02X: %s", address, esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Devices with their own completion handling (display) register over this one
+    const i2c_master_event_callbacks_t callbacks = {
+        .on_trans_done = on_transfer_done,
+    };
+    ret = i2c_master_register_event_callbacks(*dev, &callbacks, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register callbacks of device 0x%02X: %s", address, esp_err_to_name(ret));
+        i2c_master_bus_rm_device(*dev);
+        *dev = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Device 0x%02X added", address);
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_manager_transfer(i2c_master_dev_handle_t dev, const uint8_t *tx, size_t tx_len,
+                                   uint8_t *rx, size_t rx_len, int timeout_ms)
+{
+    if (request_queue == NULL || dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if ((tx_len > 0 && tx == NULL) || (rx_len > 0 && rx == NULL) || (tx_len == 0 && rx_len == 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    StaticSemaphore_t done_buffer;
+    i2c_bus_request_t req = {
+        .dev = dev,
+        .tx = tx,
+        .tx_len = tx_len,
+        .rx = rx,
+        .rx_len = rx_len,
+        .timeout_ms = timeout_ms,
+        .result = ESP_FAIL,
+        .done = xSemaphoreCreateBinaryStatic(&done_buffer),
+    };
+
+    i2c_bus_request_t *req_ptr = &req;
+    if (xQueueSend(request_queue, &req_ptr, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // The request lives on this stack, wait until the bus task released it
+    xSemaphoreTake(req.done, portMAX_DELAY);
+    return req.result;
+}
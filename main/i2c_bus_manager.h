@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize the shared I2C bus and start the bus task
+ *
+ * Safe to call more than once, later calls return ESP_OK.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t i2c_bus_manager_init(void);
+
+/**
+ * @brief Get the bus handle
+ *
+ * @return Bus handle, NULL before i2c_bus_manager_init()
+ */
+i2c_master_bus_handle_t i2c_bus_manager_get_bus(void);
+
+/**
+ * @brief Probe an address and add the device to the bus
+ *
+ * Transfers of the device are asynchronous; a completion callback is
+ * registered so i2c_bus_manager_transfer() reports NACKs and timeouts.
+ * Devices that do not use the bus task may register their own instead.
+ *
+ * @param address      7-bit device address
+ * @param scl_speed_hz SCL frequency used for this device
+ * @param dev          Receives the device handle
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no device acknowledged the address
+ */
+esp_err_t i2c_bus_manager_add_device(uint16_t address, uint32_t scl_speed_hz, i2c_master_dev_handle_t *dev);
+
+/**
+ * @brief Run a transaction on the bus task
+ *
+ * Transactions of all callers are queued and executed in order by the bus
+ * task. The caller blocks until its transaction is complete. Writes tx (if
+ * tx_len > 0), then reads rx (if rx_len > 0) after a repeated start.
+ *
+ * @param dev        Device handle from i2c_bus_manager_add_device()
+ * @param tx         Bytes to write
+ * @param tx_len     Number of bytes to write
+ * @param rx         Buffer for read bytes
+ * @param rx_len     Number of bytes to read
+ * @param timeout_ms Transfer timeout
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the queue stays full or the transfer did not complete,
+ *         ESP_FAIL on a NACK, driver error otherwise
+ */
+esp_err_t i2c_bus_manager_transfer(i2c_master_dev_handle_t dev, const uint8_t *tx, size_t tx_len,
+                                   uint8_t *rx, size_t rx_len, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
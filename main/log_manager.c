@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "log_manager.h"
+
+#if CONFIG_LOG_DEFERRED
+
+static const char *TAG = "log_manager";
+
+#define LOG_SLOTS       CONFIG_LOG_DEFERRED_SLOTS
+#define LOG_LINE_SIZE   CONFIG_LOG_DEFERRED_LINE_SIZE
+#define LOG_TASK_STACK  3072
+
+_Static_assert((LOG_SLOTS & (LOG_SLOTS - 1)) == 0, "CONFIG_LOG_DEFERRED_SLOTS must be a power of two");
+
+/**
+ * @brief Queue slot of the bounded lock-free queue
+ *
+ * The sequence number tells who owns the slot: at queue position pos the
+ * slot is free for a producer when seq == pos and holds a complete line
+ * for the logger task when seq == pos + 1. Producers claim positions with
+ * a compare-and-swap, so a preempted producer never blocks the others.
+ */
+typedef struct {
+    atomic_uint seq;
+    uint16_t len;
+    char line[LOG_LINE_SIZE];
+} log_slot_t;
+
+static log_slot_t slots[LOG_SLOTS];
+static atomic_uint enqueue_pos;
+static atomic_uint dequeue_pos;         // Advanced by the logger task only
+static atomic_uint dropped;
+static atomic_uint truncated;
+static uint32_t written = 0;
+static uint32_t max_depth = 0;
+static TaskHandle_t logger_task_handle = NULL;
+static vprintf_like_t console_vprintf = NULL;
+
+static int console_write(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int ret = console_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+/**
+ * @brief esp_log backend, queues the formatted line and returns
+ *
+ * The arguments are formatted here, %s arguments often point to buffers
+ * of the caller that are gone once it returns. Only the console write is
+ * deferred.
+ */
+static int deferred_vprintf(const char *fmt, va_list args)
+{
+    unsigned pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    log_slot_t *slot;
+
+    while (1) {
+        slot = &slots[pos & (LOG_SLOTS - 1)];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Slot still holds a line from the previous lap, queue is full
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    int len = vsnprintf(slot->line, sizeof(slot->line), fmt, args);
+    if (len < 0) {
+        len = 0;
+    } else if (len >= LOG_LINE_SIZE) {
+        len = LOG_LINE_SIZE - 1;
+        slot->line[len - 1] = '\n';
+        atomic_fetch_add_explicit(&truncated, 1, memory_order_relaxed);
+    }
+    slot->len = (uint16_t)len;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    if (xPortInIsrContext()) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(logger_task_handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive(logger_task_handle);
+    }
+    return len;
+}
+
+/**
+ * @brief Write the oldest queued line, false if there is none yet
+ */
+static bool write_next(void)
+{
+    unsigned pos = atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+    log_slot_t *slot = &slots[pos & (LOG_SLOTS - 1)];
+
+    // Empty, or the producer of this slot is still formatting
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1) {
+        return false;
+    }
+
+    console_write("%.*s", (int)slot->len, slot->line);
+    atomic_store_explicit(&slot->seq, pos + LOG_SLOTS, memory_order_release);
+    atomic_store_explicit(&dequeue_pos, pos + 1, memory_order_relaxed);
+    written++;
+    return true;
+}
+
+static void logger_task(void *arg)
+{
+    unsigned reported_drops = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t depth = atomic_load(&enqueue_pos) - atomic_load(&dequeue_pos);
+        if (depth > max_depth) {
+            max_depth = depth;
+        }
+
+        while (write_next()) {
+        }
+
+        unsigned drops = atomic_load_explicit(&dropped, memory_order_relaxed);
+        if (drops != reported_drops) {
+            console_write("W (%" PRIu32 ") %s: %u log lines dropped, queue full\n", esp_log_timestamp(), TAG,
+                          drops - reported_drops);
+            reported_drops = drops;
+        }
+    }
+}
+
+static void flush_on_shutdown(void)
+{
+    log_manager_flush(100);
+}
+
+esp_err_t log_manager_init(void)
+{
+    if (logger_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    for (unsigned i = 0; i < LOG_SLOTS; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+
+    if (xTaskCreate(logger_task, "logger", LOG_TASK_STACK, NULL, tskIDLE_PRIORITY + 1,
+                    &logger_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create logger task, logging stays synchronous");
+        return ESP_FAIL;
+    }
+
+    console_vprintf = esp_log_set_vprintf(deferred_vprintf);
+    esp_register_shutdown_handler(flush_on_shutdown);
+
+    ESP_LOGI(TAG, "Deferred logging, %d lines of %d bytes", LOG_SLOTS, LOG_LINE_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t log_manager_flush(uint32_t timeout_ms)
+{
+    if (logger_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    for (uint32_t waited = 0; atomic_load(&enqueue_pos) != atomic_load(&dequeue_pos); waited += 10) {
+        if (waited >= timeout_ms) {
+            return ESP_ERR_TIMEOUT;
+        }
+        xTaskNotifyGive(logger_task_handle);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return ESP_OK;
+}
+
+void log_manager_get_stats(log_stats_t *stats)
+{
+    stats->written = written;
+    stats->dropped = atomic_load_explicit(&dropped, memory_order_relaxed);
+    stats->truncated = atomic_load_explicit(&truncated, memory_order_relaxed);
+    stats->max_depth = max_depth;
+}
+
+#else
+
+esp_err_t log_manager_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t log_manager_flush(uint32_t timeout_ms)
+{
+    return ESP_OK;
+}
+
+void log_manager_get_stats(log_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Deferred logging counters
+ */
+typedef struct {
+    uint32_t written;       // Lines written to the console
+    uint32_t dropped;       // Lines dropped because the queue was full
+    uint32_t truncated;     // Lines cut to CONFIG_LOG_DEFERRED_LINE_SIZE
+    uint32_t max_depth;     // Most lines waiting at once
+} log_stats_t;
+
+/**
+ * @brief Route ESP_LOGx output through the deferred logger
+ *
+ * Installs an esp_log_set_vprintf() backend that formats the line into a
+ * slot of a lock-free queue and returns without touching the UART. A low
+ * priority task writes the queued lines to the console. When the queue is
+ * full the line is dropped and counted, the caller never blocks.
+ * Without CONFIG_LOG_DEFERRED logging stays synchronous.
+ *
+ * Call early in app_main(), lines logged before stay synchronous.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the logger task could not be created
+ */
+esp_err_t log_manager_init(void);
+
+/**
+ * @brief Wait until the queued lines were written
+ *
+ * Called before deep sleep and from the restart shutdown handler so the
+ * last lines are not lost.
+ *
+ * @param timeout_ms Maximum time to wait
+ * @return ESP_OK when the queue is empty, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t log_manager_flush(uint32_t timeout_ms);
+
+/**
+ * @brief Get the deferred logging counters
+ */
+void log_manager_get_stats(log_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,9 @@
 #include "sdkconfig.h"
 #include "ds18b20_manager.h"
 #include "dht22_manager.h"
+#include "sht3x_manager.h"
+#include "bme280_manager.h"
+#include "i2c_bus_manager.h"
 #include "ssd1306_manager.h"
 #include "button_manager.h"
 #include "adc_manager.h"
@@ -16,11 +19,148 @@
 #include "wifi_manager.h"
 #include "mqtt_manager.h"
 #include "system.h"
+#include "config_manager.h"
+#include "alarm_manager.h"
+#include "sampling_scheduler.h"
+#include "sleep_manager.h"
+#include "power_manager.h"
+#include "boot_sequence.h"
+#include "sample_pipeline.h"
+#include "trace_manager.h"
+#include "log_manager.h"
+#include "bench_console.h"
+#include "capture_manager.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "messages/message_formatter.h"
 #include <stdlib.h>
+#include <string.h>
 
 static const char *TAG = "example";
 
+#define DEVICE_TOPIC_SIZE 96
+#define MAX_IDLE_WAIT_MS 1000
+#define BOOT_TIMELINE_SIZE 1024
+#define METRICS_MESSAGE_SIZE 1024
+
+static char device_id[13];
+static char command_topic[DEVICE_TOPIC_SIZE];
+static char response_topic[DEVICE_TOPIC_SIZE];
+static char power_topic[DEVICE_TOPIC_SIZE];
+static char boot_topic[DEVICE_TOPIC_SIZE];
+static char diag_topic[DEVICE_TOPIC_SIZE];
+static char trace_request_topic[DEVICE_TOPIC_SIZE];
+static char trace_topic[DEVICE_TOPIC_SIZE];
+static char bench_topic[DEVICE_TOPIC_SIZE];
+static char capture_topic[DEVICE_TOPIC_SIZE];
+
+/* milliseconds since cold boot, continues across deep sleep */
+static uint32_t uptime_ms(void)
+{
+    return sleep_manager_time_ms();
+}
+
+/**
+ * @brief Publish alarm state change immediately, ahead of telemetry
+ */
+static void alarm_event_handler(const alarm_event_t *event)
+{
+    // Stale alarms report sample age in ms, other rules use the source units
+    int decimals = 0;
+    if (event->rule->type != ALARM_RULE_STALE) {
+        switch (event->rule->source) {
+            case ALARM_SOURCE_DS18B20_TEMP:
+            case ALARM_SOURCE_DHT22_TEMP:
+            case ALARM_SOURCE_SHT3X_TEMP:
+            case ALARM_SOURCE_BME280_TEMP:
+                decimals = 2;
+                break;
+            case ALARM_SOURCE_DHT22_HUMIDITY:
+                decimals = 1;
+                break;
+            default:
+                break;
+        }
+    }
+
+    char msg[192];
+    int len = format_alarm_message(msg, sizeof(msg), device_id,
+                                   alarm_manager_source_name(event->rule->source),
+                                   alarm_manager_rule_name(event->rule->type),
+                                   event->active, event->value, event->rule->threshold,
+                                   decimals, event->timestamp_ms);
+    if (len > 0) {
+        mqtt_manager_publish(CONFIG_MQTT_ALARM_TOPIC, msg, 1, false);
+    }
+}
+
+/**
+ * @brief Handle messages received on the command topic
+ */
+static void command_handler(const char *topic, size_t topic_len, const char *data, size_t data_len)
+{
+    char response[192];
+    config_manager_handle_command(data, data_len, response, sizeof(response));
+    mqtt_manager_publish(response_topic, response, 1, false);
+}
+
+static void publish_trace_line(const char *line, void *ctx)
+{
+    mqtt_manager_publish(trace_topic, line, 1, false);
+}
+
+/**
+ * @brief Send a batch of raw sensor reads, for replay in the host build
+ */
+static void publish_capture(const char *lines, void *ctx)
+{
+#if CONFIG_CAPTURE_OUTPUT_CONSOLE
+    fputs(lines, stdout);
+#else
+    mqtt_manager_publish(capture_topic, lines, 1, false);
+#endif
+}
+
+/**
+ * @brief Dump the trace ring on request, payload "console" prints it to the console instead
+ */
+static void trace_request_handler(const char *topic, size_t topic_len, const char *data, size_t data_len)
+{
+    if (data_len == strlen("console") && memcmp(data, "console", data_len) == 0) {
+        trace_manager_print();
+    } else {
+        trace_manager_dump(publish_trace_line, NULL);
+    }
+}
+
+/* latest values shown on the display (0.01 °C, 0.1 %RH) */
+static int32_t last_ds_temperature = 0;
+static int32_t last_dht_temperature = 0;
+static int32_t last_dht_humidity = 0;
+
+/**
+ * @brief Keep the display values current, called for every valid sample
+ */
+static void sample_listener(sample_source_t source, const int32_t *values, size_t count)
+{
+    switch (source) {
+        case SAMPLE_SOURCE_DS18B20:
+            last_ds_temperature = values[0];
+            set_temp_values(last_ds_temperature, last_dht_temperature, last_dht_humidity);
+            break;
+        case SAMPLE_SOURCE_DHT22:
+            last_dht_temperature = values[0];
+            last_dht_humidity = values[1];
+            set_temp_values(last_ds_temperature, last_dht_temperature, last_dht_humidity);
+            break;
+        case SAMPLE_SOURCE_ADC:
+            set_voltage_value(values[0]);
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * @brief Callback function for button events
  */
@@ -29,6 +169,11 @@ static void button_event_handler(gpio_num_t gpio, button_event_t event)
     switch (event) {
         case BUTTON_EVENT_PRESSED:
             ESP_LOGI(TAG, ">>> Button on GPIO %d PRESSED", gpio);
+
+            // First press only wakes the display
+            if (ssd1306_manager_wake()) {
+                break;
+            }
             
             if (gpio == button_manager_get_button0_gpio()) {
                 // Button 0 (GPIO 1) - Previous screen
@@ -39,8 +184,6 @@ static void button_event_handler(gpio_num_t gpio, button_event_t event)
                 ESP_LOGI(TAG, "Button 1: Next screen");
                 ssd1306_manager_next_screen();
             }
-
-            ssd1306_manager_update_display();
             break;
             
         case BUTTON_EVENT_RELEASED:
@@ -63,11 +206,152 @@ static void button_event_handler(gpio_num_t gpio, button_event_t event)
                 esp_restart();
             }
             break;
+
+        case BUTTON_EVENT_DOUBLE_CLICK: {
+            button_latency_stats_t stats;
+            button_manager_get_latency_stats(&stats);
+            ESP_LOGI(TAG, ">>> Button on GPIO %d DOUBLE CLICK, latency min %lu / avg %lu / max %lu us (%lu events)",
+                     gpio, stats.min_us, stats.avg_us, stats.max_us, stats.count);
+            break;
+        }
+    }
+}
+
+#if CONFIG_DUTY_CYCLE_MODE
+/**
+ * @brief Publish wake count, awake time and estimated current of the previous cycle
+ */
+static void publish_power_report(void)
+{
+    sleep_stats_t stats;
+    sleep_manager_get_stats(&stats);
+    if (stats.wake_count == 0) {
+        return;     // Cold boot, no cycle completed yet
+    }
+
+    char msg[128];
+    if (format_power_report(msg, sizeof(msg), device_id, stats.wake_count, stats.last_awake_ms,
+                            stats.avg_current_ua) > 0) {
+        mqtt_manager_publish(power_topic, msg, 0, false);
+    }
+}
+
+/**
+ * @brief End the wake, wait for messages in flight and enter deep sleep
+ */
+static void duty_cycle_sleep(uint32_t sleep_ms)
+{
+    ESP_LOGI(TAG, "%" PRIu32 " messages published since cold boot", sample_pipeline_published());
+
+    capture_manager_flush();
+    mqtt_manager_flush(CONFIG_DUTY_CYCLE_FLUSH_TIMEOUT_MS);
+    sleep_manager_enter(sleep_ms);
+}
+#endif
+
+static esp_err_t boot_mqtt(void)
+{
+    // Returns at once, messages are buffered until the broker is reached
+    return mqtt_init(NULL, 0);
+}
+
+static esp_err_t boot_i2c_sensors(void)
+{
+    // Optional sensors, absence is reported through *_is_present()
+    sht3x_manager_init();
+    bme280_manager_init();
+    return ESP_OK;
+}
+
+#if !CONFIG_DUTY_CYCLE_MODE
+static esp_err_t boot_buttons(void)
+{
+    const gpio_num_t button_gpios[] = { CONFIG_BUTTON0_GPIO, CONFIG_BUTTON1_GPIO };
+    return button_manager_init(button_gpios, sizeof(button_gpios) / sizeof(button_gpios[0]), button_event_handler);
+}
+#endif
+
+/**
+ * @brief Init graph, steps run as soon as their dependencies are done
+ */
+typedef enum {
+    BOOT_WIFI,
+    BOOT_POWER,
+    BOOT_CONFIG,
+    BOOT_MQTT,
+    BOOT_I2C,
+    BOOT_DS18B20,
+    BOOT_DHT22,
+    BOOT_I2C_SENSORS,
+    BOOT_ADC,
+    BOOT_DISPLAY,
+    BOOT_BUTTONS,
+    BOOT_STEP_COUNT
+} boot_step_id_t;
+
+static const boot_step_t boot_steps[BOOT_STEP_COUNT] = {
+    [BOOT_WIFI]        = { "wifi", wifi_init, 0 },
+    [BOOT_POWER]       = { "power", power_manager_init, 0 },
+    // Applies the stored power profile, which sets the Wi-Fi power save mode
+    [BOOT_CONFIG]      = { "config", config_manager_init, BOOT_DEP(BOOT_WIFI) | BOOT_DEP(BOOT_POWER) },
+    [BOOT_MQTT]        = { "mqtt", boot_mqtt, BOOT_DEP(BOOT_WIFI) },
+    [BOOT_I2C]         = { "i2c", i2c_bus_manager_init, 0 },
+    [BOOT_DS18B20]     = { "ds18b20", ds18b20_manager_init, 0 },
+    [BOOT_DHT22]       = { "dht22", dht22_manager_init, 0 },
+    [BOOT_I2C_SENSORS] = { "i2c_sensors", boot_i2c_sensors, BOOT_DEP(BOOT_I2C) },
+    [BOOT_ADC]         = { "adc", adc_manager_init, 0 },
+#if CONFIG_DUTY_CYCLE_MODE
+    // No display or buttons on battery powered probes
+    [BOOT_DISPLAY]     = { "display", NULL, 0 },
+    [BOOT_BUTTONS]     = { "buttons", NULL, 0 },
+#else
+    [BOOT_DISPLAY]     = { "display", ssd1306_manager_init, BOOT_DEP(BOOT_I2C) },
+    // The button handler wakes the display
+    [BOOT_BUTTONS]     = { "buttons", boot_buttons, BOOT_DEP(BOOT_DISPLAY) },
+#endif
+};
+
+/**
+ * @brief Publish the boot timeline, the first message after a boot
+ */
+static void publish_boot_timeline(const boot_phase_t *timeline)
+{
+    char *msg = malloc(BOOT_TIMELINE_SIZE);
+    if (msg == NULL) {
+        return;
+    }
+    if (format_boot_timeline(msg, BOOT_TIMELINE_SIZE, device_id, timeline, BOOT_STEP_COUNT,
+                             (uint32_t)(esp_timer_get_time() / 1000)) > 0) {
+        mqtt_manager_publish(boot_topic, msg, 1, false);
+    }
+    free(msg);
+}
+
+#if CONFIG_SYSTEM_METRICS_PERIOD_S > 0
+/**
+ * @brief Publish a runtime metrics snapshot, called from the metrics task
+ */
+static void publish_metrics(const system_metrics_t *metrics)
+{
+    char *msg = malloc(METRICS_MESSAGE_SIZE);
+    if (msg == NULL) {
+        return;
+    }
+    if (format_system_metrics(msg, METRICS_MESSAGE_SIZE, device_id, metrics) > 0) {
+        mqtt_manager_publish(diag_topic, msg, 0, false);
+    } else {
+        ESP_LOGW(TAG, "Metrics message does not fit %d bytes", METRICS_MESSAGE_SIZE);
     }
+    free(msg);
 }
+#endif
 
 void app_main(void)
 {
+    sleep_manager_init();
+    // Console writes move to a low priority task, callers no longer wait for the UART
+    log_manager_init();
+
     ESP_LOGI(TAG, "[APP] Startup..");
     ESP_LOGI(TAG, "[APP] Free memory: %" PRIu32 " bytes", esp_get_free_heap_size());
     ESP_LOGI(TAG, "[APP] IDF version: %s", esp_get_idf_version());
@@ -75,80 +359,75 @@ void app_main(void)
 
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-    wifi_init();
-    mqtt_init(NULL, 0);
+    system_get_device_id(device_id, sizeof(device_id));
+    snprintf(command_topic, sizeof(command_topic), "%s/%s/cmd", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(response_topic, sizeof(response_topic), "%s/%s/resp", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(power_topic, sizeof(power_topic), "%s/%s/power", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(boot_topic, sizeof(boot_topic), "%s/%s/boot", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(diag_topic, sizeof(diag_topic), "%s/%s/diag", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(trace_request_topic, sizeof(trace_request_topic), "%s/%s/trace/get", CONFIG_MQTT_DEVICE_TOPIC_ROOT,
+             device_id);
+    snprintf(trace_topic, sizeof(trace_topic), "%s/%s/trace", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(bench_topic, sizeof(bench_topic), "%s/%s/bench", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    snprintf(capture_topic, sizeof(capture_topic), "%s/%s/capture", CONFIG_MQTT_DEVICE_TOPIC_ROOT, device_id);
+    ESP_LOGI(TAG, "Device id %s, command topic %s", device_id, command_topic);
 
-    ds18b20_manager_init();
-    dht22_manager_init();
-    adc_manager_init();
-    button_manager_init(button_event_handler);
-    ssd1306_manager_init();
-    
-    // Give sensors time to stabilize
-    ESP_LOGI(TAG, "Waiting for sensors to stabilize...");
-    vTaskDelay(pdMS_TO_TICKS(3000));
+    mqtt_manager_register_handler(command_topic, command_handler);
+    mqtt_manager_register_handler(trace_request_topic, trace_request_handler);
+    alarm_manager_init(alarm_event_handler);
 
-    while (1) {
-        // Read DS18B20 temperature sensor
-        float ds_temperature = 0.0f;
-        char rom_code_s[17];
-
-        ds18b20_manager_get_device_address(0, rom_code_s);
-        ds18b20_manager_read_temperature(0, &ds_temperature);
-        /* format_temperature_message returns an allocated string; use it and free it */
-        char *json_msg = format_message(rom_code_s, "DS18B20", &ds_temperature, NULL, NULL);
-        if (json_msg) {
-            ESP_LOGI(TAG, "DS18B20 message: %s", json_msg);
-            mqtt_manager_publish("test/sensors/temperature", json_msg, 1, false);
-            free(json_msg);
-        }
+    // Network connect, display bring-up and sensor warm-up delays overlap
+    static boot_phase_t boot_timeline[BOOT_STEP_COUNT];
+    if (boot_sequence_run(boot_steps, BOOT_STEP_COUNT, boot_timeline) != ESP_OK) {
+        ESP_LOGW(TAG, "Boot finished with failed steps");
+    }
 
-        // Read DHT22 temperature and humidity sensor
-        float dht_temperature = 0.0f;
-        float dht_humidity = 0.0f;
-        
-        esp_err_t dht_status = dht22_manager_read_data(&dht_temperature, &dht_humidity);
-        if (dht_status == ESP_OK) {
-            ESP_LOGI(TAG, "DHT22 - Temperature: %.1f°C, Humidity: %.1f%%", dht_temperature, dht_humidity);
-            
-            // Display temperatures on SSD1306 OLED (only if DHT22 is working)
-            set_temp_values(ds_temperature, dht_temperature, dht_humidity);
-        } else {
-            ESP_LOGW(TAG, "Failed to read DHT22 sensor, skipping display update");
-        }
-        
-        /* format_temperature_message returns an allocated string; use it and free it */
-        char *json_msg2 = format_message("T01", "DHT22", &dht_temperature, &dht_humidity, NULL);
-        if (json_msg2) {
-            ESP_LOGI(TAG, "DHT22 message: %s", json_msg2);
-            mqtt_manager_publish("test/sensors/temperature", json_msg2, 1, false);
-            free(json_msg2);
-        }
+#if CONFIG_DUTY_CYCLE_MODE
+    // Samples of this wake are published in one burst once connected
+    if (mqtt_manager_wait_connected(CONFIG_DUTY_CYCLE_CONNECT_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGW(TAG, "MQTT not connected, samples of this wake are not published");
+    }
+#endif
+    publish_boot_timeline(boot_timeline);
+#if CONFIG_DUTY_CYCLE_MODE
+    publish_power_report();
+#endif
+#if CONFIG_SYSTEM_METRICS_PERIOD_S > 0
+    system_metrics_start(CONFIG_SYSTEM_METRICS_PERIOD_S * 1000, publish_metrics);
+#endif
 
-        // Read ADC voltage (with 1:1 voltage divider)
-        int voltage_mv = 0;
-        float voltage_v = 0.0f;
-        esp_err_t adc_status = adc_manager_read_voltage(&voltage_mv);
-        if (adc_status == ESP_OK) {
-            set_voltage_value(voltage_mv);
-            ESP_LOGI(TAG, "ADC - Voltage: %d mV (%.2f V)", voltage_mv, voltage_mv / 1000.0f);
-        } else {
-            ESP_LOGW(TAG, "Failed to read ADC voltage");
-        }
+    // The DHT22 init covers the sensor warm-up, the scheduler state survives deep sleep
+    if (!sleep_manager_is_wake()) {
+        sampling_scheduler_init(uptime_ms());
+    }
+    sampling_scheduler_set_enabled(SAMPLE_SOURCE_SHT3X, sht3x_manager_is_present());
+    sampling_scheduler_set_enabled(SAMPLE_SOURCE_BME280, bme280_manager_is_present());
 
-        voltage_v = voltage_mv / 1000.0f;
-    
-        /* format_temperature_message returns an allocated string; use it and free it */
-        char *json_msg3 = format_message("T01", "V", NULL, NULL, &voltage_v);
-        if (json_msg3) {
-            ESP_LOGI(TAG, "ADC message: %s", json_msg3);
-            mqtt_manager_publish("test/sensors/voltage", json_msg3, 1, false);
-            free(json_msg3);
-        }
+    capture_manager_init(uptime_ms, publish_capture, NULL);
+    sample_pipeline_init(uptime_ms, sample_listener);
+    // Profiling of field units over the serial console, without a special build
+    bench_console_init(bench_topic);
+
+    while (1) {
+        app_config_t cfg;
+        config_manager_get(&cfg);
 
-        // Update display with all data (will show current screen)
-        ssd1306_manager_update_display();
+        uint32_t wait_ms = 0;
+        if (sample_pipeline_poll(&cfg, &wait_ms)) {
+            // Request a redraw with the new data, rendered by the display task
+            ssd1306_manager_update_display();
+            continue;
+        }
 
-        vTaskDelay(10000/portTICK_PERIOD_MS);
+#if CONFIG_DUTY_CYCLE_MODE
+        // Everything due was sampled, sleep until the next sensor is due
+        if (wait_ms >= CONFIG_DUTY_CYCLE_MIN_SLEEP_MS) {
+            duty_cycle_sleep(wait_ms);
+        }
+#endif
+        // Wake up at least every second so config changes apply promptly
+        alarm_manager_check_stale(uptime_ms());
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms < MAX_IDLE_WAIT_MS ? wait_ms : MAX_IDLE_WAIT_MS);
+        vTaskDelay(ticks > 0 ? ticks : 1);
     }
 }
@@ -0,0 +1,27 @@
+#ifndef BOOT_PHASE_H
+#define BOOT_PHASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One phase of the boot timeline
+ *
+ * Times are milliseconds since the application started.
+ */
+typedef struct {
+    const char *name;       // Phase name, NULL for a phase that was not run
+    uint32_t start_ms;      // Phase started (dependencies done)
+    uint32_t end_ms;        // Phase finished
+    bool ok;                // Phase succeeded
+} boot_phase_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_PHASE_H
@@ -0,0 +1,129 @@
+#include "command_parser.h"
+#include <string.h>
+
+static bool is_separator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ';';
+}
+
+bool command_parser_next(const char **cursor, const char *end, command_token_t *token)
+{
+    if (!cursor || !*cursor || !end || !token) {
+        return false;
+    }
+
+    const char *p = *cursor;
+
+    // Skip leading separators
+    while (p < end && is_separator(*p)) {
+        p++;
+    }
+    if (p >= end) {
+        *cursor = end;
+        return false;
+    }
+
+    token->key = p;
+    token->value = NULL;
+    token->value_len = 0;
+
+    while (p < end && !is_separator(*p) && *p != '=') {
+        p++;
+    }
+    token->key_len = (size_t)(p - token->key);
+
+    if (p < end && *p == '=') {
+        p++;
+        token->value = p;
+        while (p < end && !is_separator(*p)) {
+            p++;
+        }
+        token->value_len = (size_t)(p - token->value);
+    }
+
+    *cursor = p;
+    return true;
+}
+
+bool command_token_is(const command_token_t *token, const char *key)
+{
+    size_t len = strlen(key);
+    return token->key_len == len && memcmp(token->key, key, len) == 0;
+}
+
+bool command_parse_uint(const char *str, size_t len, uint32_t *out)
+{
+    if (!str || len == 0 || !out) {
+        return false;
+    }
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return false;
+        }
+        uint32_t digit = (uint32_t)(str[i] - '0');
+        if (value > (UINT32_MAX - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+
+    *out = value;
+    return true;
+}
+
+bool command_parse_fixed(const char *str, size_t len, int decimals, int32_t *out)
+{
+    if (!str || len == 0 || !out || decimals < 0 || decimals > 6) {
+        return false;
+    }
+
+    bool negative = false;
+    size_t i = 0;
+    if (str[0] == '-' || str[0] == '+') {
+        negative = (str[0] == '-');
+        i++;
+    }
+
+    int64_t value = 0;
+    int fraction_digits = -1;   // -1 until the decimal point is seen
+    bool any_digit = false;
+
+    for (; i < len; i++) {
+        char c = str[i];
+        if (c == '.') {
+            if (fraction_digits >= 0) {
+                return false;
+            }
+            fraction_digits = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        if (fraction_digits >= 0 && ++fraction_digits > decimals) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+        any_digit = true;
+        if (value > INT32_MAX) {
+            return false;
+        }
+    }
+
+    if (!any_digit) {
+        return false;
+    }
+
+    // Scale up to the requested number of fraction digits
+    for (int d = (fraction_digits < 0 ? 0 : fraction_digits); d < decimals; d++) {
+        value *= 10;
+        if (value > INT32_MAX) {
+            return false;
+        }
+    }
+
+    *out = (int32_t)(negative ? -value : value);
+    return true;
+}
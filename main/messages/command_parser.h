@@ -0,0 +1,72 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Single token of a command payload
+ *
+ * Points into the payload buffer, nothing is copied. For a bare word
+ * (e.g. "get") value is NULL and value_len is 0.
+ */
+typedef struct {
+    const char *key;
+    size_t key_len;
+    const char *value;
+    size_t value_len;
+} command_token_t;
+
+/**
+ * @brief Get next token from a command payload
+ *
+ * Payload format is a list of "key=value" pairs or bare words separated by
+ * whitespace, ',' or ';', e.g. "period=5000 db_temp=0.25 log=debug".
+ * The payload does not have to be NUL-terminated.
+ *
+ * @param cursor Read position, advanced past the returned token
+ * @param end    End of the payload
+ * @param token  Filled with the next token
+ * @return true if a token was returned, false at the end of the payload
+ */
+bool command_parser_next(const char **cursor, const char *end, command_token_t *token);
+
+/**
+ * @brief Compare token key with a NUL-terminated string
+ */
+bool command_token_is(const command_token_t *token, const char *key);
+
+/**
+ * @brief Parse unsigned decimal integer
+ *
+ * @param str Value text (not NUL-terminated)
+ * @param len Value length
+ * @param out Parsed value
+ * @return true on success, false on empty input, non-digits or overflow
+ */
+bool command_parse_uint(const char *str, size_t len, uint32_t *out);
+
+/**
+ * @brief Parse signed decimal number into fixed-point integer
+ *
+ * Integer-only, no float involved. "0.25" with decimals=2 gives 25,
+ * "-1.5" with decimals=1 gives -15. Extra fraction digits are rejected.
+ *
+ * @param str      Value text (not NUL-terminated)
+ * @param len      Value length
+ * @param decimals Number of fraction digits of the result (0-6)
+ * @param out      Parsed value scaled by 10^decimals
+ * @return true on success, false on malformed input or overflow
+ */
+bool command_parse_fixed(const char *str, size_t len, int decimals, int32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMAND_PARSER_H
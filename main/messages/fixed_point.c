@@ -0,0 +1,40 @@
+#include "fixed_point.h"
+#include <stdio.h>
+#include <inttypes.h>
+
+int format_fixed(char *out, size_t size, int32_t value, int decimals)
+{
+    uint32_t scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+
+    const char *sign = value < 0 ? "-" : "";
+    uint32_t abs_value = value < 0 ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+
+    if (decimals <= 0) {
+        return snprintf(out, size, "%s%" PRIu32, sign, abs_value);
+    }
+    return snprintf(out, size, "%s%" PRIu32 ".%0*" PRIu32, sign,
+                    abs_value / scale, decimals, abs_value % scale);
+}
+
+int32_t fixed_rescale(int32_t value, int from_decimals, int to_decimals)
+{
+    int32_t result = value;
+
+    for (int d = from_decimals; d < to_decimals; d++) {
+        result *= 10;
+    }
+
+    if (from_decimals > to_decimals) {
+        int32_t divisor = 1;
+        for (int d = to_decimals; d < from_decimals; d++) {
+            divisor *= 10;
+        }
+        int32_t half = divisor / 2;
+        result = value >= 0 ? (value + half) / divisor : (value - half) / divisor;
+    }
+
+    return result;
+}
@@ -0,0 +1,42 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Format fixed-point value as decimal text using integer math only
+ *
+ * format_fixed(buf, sizeof(buf), 2345, 2) gives "23.45",
+ * format_fixed(buf, sizeof(buf), -5, 1) gives "-0.5".
+ *
+ * @param out      Output buffer
+ * @param size     Size of the output buffer
+ * @param value    Value scaled by 10^decimals
+ * @param decimals Number of fraction digits (0-9)
+ * @return Number of characters that would have been written (like snprintf)
+ */
+int format_fixed(char *out, size_t size, int32_t value, int decimals);
+
+/**
+ * @brief Change the number of fraction digits of a fixed-point value
+ *
+ * Rounds half away from zero when digits are removed, e.g.
+ * fixed_rescale(2345, 2, 1) gives 235 and fixed_rescale(-2345, 2, 1) gives -235.
+ *
+ * @param value Value scaled by 10^from_decimals
+ * @param from_decimals Fraction digits of value
+ * @param to_decimals Fraction digits of the result
+ * @return Value scaled by 10^to_decimals
+ */
+int32_t fixed_rescale(int32_t value, int from_decimals, int to_decimals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIXED_POINT_H
@@ -1,8 +1,10 @@
 #include "message_formatter.h"
+#include "fixed_point.h"
 #include "cJSON.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <inttypes.h>
 
 #define VALUE_BUFFER_SIZE 16
 
@@ -11,18 +13,15 @@
  * 
  * @param data_obj      Parent cJSON object to add the measurement to
  * @param field_name    Name of the field (e.g., "temperature", "humidity")
- * @param value         Pointer to the float value
+ * @param value         Fixed-point value
+ * @param decimals      Number of fraction digits of value
  * @param unit          Unit string (e.g., "C", "%", "V")
- * @param precision     Number of decimal places (0-3)
+ * @param precision     Number of decimal places printed (0-3)
  * @return true on success, false on allocation failure
  */
-static bool add_measurement(cJSON *data_obj, const char *field_name, float *value, 
+static bool add_measurement(cJSON *data_obj, const char *field_name, int32_t value, int decimals,
                            const char *unit, int precision)
 {
-    if (!value) {
-        return true;  // NULL value is not an error, just skip
-    }
-
     cJSON *measurement = cJSON_CreateObject();
     if (!measurement) {
         return false;
@@ -30,7 +29,7 @@ static bool add_measurement(cJSON *data_obj, const char *field_name, float *valu
 
     // Format value with specified precision
     char value_str[VALUE_BUFFER_SIZE];
-    snprintf(value_str, sizeof(value_str), "%.*f", precision, *value);
+    format_fixed(value_str, sizeof(value_str), fixed_rescale(value, decimals, precision), precision);
     
     if (!cJSON_AddStringToObject(measurement, "value", value_str)) {
         cJSON_Delete(measurement);
@@ -56,17 +55,13 @@ static bool add_measurement(cJSON *data_obj, const char *field_name, float *valu
  * Creates a JSON message with sensor data.
  * At least one measurement value should be provided for a meaningful message.
  *
- * @param id          NUL-terminated device ID string (required)
- * @param sensor      NUL-terminated sensor type string (optional, can be NULL)
- * @param temperature Temperature value in Celsius (optional, can be NULL)
- * @param humidity    Humidity value in percent (optional, can be NULL)
- * @param voltage     Voltage value in Volts (optional, can be NULL)
+ * @param sample Sample to format (id required)
  * @return Allocated JSON string on success (caller MUST free()),
  *         NULL on error (invalid arguments or allocation failure).
  */
-char *format_message(const char *id, const char *sensor, float *temperature, float *humidity, float *voltage)
+char *format_message(const sensor_sample_t *sample)
 {
-    if (!id) {
+    if (!sample || !sample->id) {
         return NULL;
     }
 
@@ -77,16 +72,26 @@ char *format_message(const char *id, const char *sensor, float *temperature, flo
     }
 
     // Add device ID (required field)
-    if (!cJSON_AddStringToObject(root, "id", id)) {
+    if (!cJSON_AddStringToObject(root, "id", sample->id)) {
         cJSON_Delete(root);
         return NULL;
     }
     
     // Add sensor type (optional field)
-    if (sensor && !cJSON_AddStringToObject(root, "sensor", sensor)) {
+    if (sample->sensor && !cJSON_AddStringToObject(root, "sensor", sample->sensor)) {
         cJSON_Delete(root);
         return NULL;
     }
+
+    // Add sampling period (optional field), as raw text so cJSON does not print a double
+    if (sample->period_ms > 0) {
+        char period_str[VALUE_BUFFER_SIZE];
+        snprintf(period_str, sizeof(period_str), "%" PRIu32, sample->period_ms);
+        if (!cJSON_AddRawToObject(root, "period_ms", period_str)) {
+            cJSON_Delete(root);
+            return NULL;
+        }
+    }
     
     // Create data object for measurements
     cJSON *data = cJSON_CreateObject();
@@ -96,12 +101,15 @@ char *format_message(const char *id, const char *sensor, float *temperature, flo
     }
     
     // Add measurements with specified precision:
-    // - temperature: 1 decimal place (e.g., "23.4")
-    // - humidity: 1 decimal place (e.g., "65.2")
-    // - voltage: 2 decimal places (e.g., "3.14")
-    if (!add_measurement(data, "temperature", temperature, "C", 1) ||
-        !add_measurement(data, "humidity", humidity, "%", 1) ||
-        !add_measurement(data, "voltage", voltage, "V", 2)) {
+    // - temperature: 0.01 °C -> 1 decimal place (e.g., "23.4")
+    // - humidity: 0.1 %RH -> 1 decimal place (e.g., "65.2")
+    // - voltage: mV -> 2 decimal places of V (e.g., "3.14")
+    if (((sample->fields & SENSOR_SAMPLE_TEMPERATURE) &&
+         !add_measurement(data, "temperature", sample->temperature, 2, "C", 1)) ||
+        ((sample->fields & SENSOR_SAMPLE_HUMIDITY) &&
+         !add_measurement(data, "humidity", sample->humidity, 1, "%", 1)) ||
+        ((sample->fields & SENSOR_SAMPLE_VOLTAGE) &&
+         !add_measurement(data, "voltage", sample->voltage, 3, "V", 2))) {
         cJSON_Delete(data);
         cJSON_Delete(root);
         return NULL;
@@ -121,4 +129,138 @@ char *format_message(const char *id, const char *sensor, float *temperature, flo
     cJSON_Delete(root);
 
     return json_str;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Format alarm message as JSON into a caller provided buffer
+ *
+ * @return Length of the message on success, -1 on error.
+ */
+int format_alarm_message(char *buf, size_t size, const char *id, const char *sensor, const char *alarm,
+                         bool active, int32_t value, int32_t threshold, int decimals, uint32_t ts_ms)
+{
+    if (!buf || !id || !sensor || !alarm) {
+        return -1;
+    }
+
+    char value_str[VALUE_BUFFER_SIZE];
+    char threshold_str[VALUE_BUFFER_SIZE];
+    format_fixed(value_str, sizeof(value_str), value, decimals);
+    format_fixed(threshold_str, sizeof(threshold_str), threshold, decimals);
+
+    int len = snprintf(buf, size,
+                       "{\"id\":\"%s\",\"sensor\":\"%s\",\"alarm\":\"%s\",\"state\":\"%s\","
+                       "\"value\":\"%s\",\"threshold\":\"%s\",\"ts\":%" PRIu32 "}",
+                       id, sensor, alarm, active ? "active" : "cleared",
+                       value_str, threshold_str, ts_ms);
+    if (len < 0 || (size_t)len >= size) {
+        return -1;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Format duty-cycle power report as JSON into a caller provided buffer
+ *
+ * @return Length of the message on success, -1 on error.
+ */
+int format_power_report(char *buf, size_t size, const char *id, uint32_t wake_count, uint32_t awake_ms,
+                        uint32_t avg_current_ua)
+{
+    if (!buf || !id) {
+        return -1;
+    }
+
+    int len = snprintf(buf, size,
+                       "{\"id\":\"%s\",\"wake\":%" PRIu32 ",\"awake_ms\":%" PRIu32 ",\"current_ua\":%" PRIu32 "}",
+                       id, wake_count, awake_ms, avg_current_ua);
+    if (len < 0 || (size_t)len >= size) {
+        return -1;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Format boot timeline as JSON into a caller provided buffer
+ *
+ * @return Length of the message on success, -1 on error.
+ */
+int format_boot_timeline(char *buf, size_t size, const char *id, const boot_phase_t *phases, size_t count,
+                         uint32_t boot_ms)
+{
+    if (!buf || !id || (!phases && count > 0)) {
+        return -1;
+    }
+
+    int len = snprintf(buf, size, "{\"id\":\"%s\",\"boot_ms\":%" PRIu32 ",\"phases\":[", id, boot_ms);
+    bool first = true;
+
+    for (size_t i = 0; i < count && len >= 0 && (size_t)len < size; i++) {
+        if (!phases[i].name) {
+            continue;
+        }
+        len += snprintf(buf + len, size - (size_t)len,
+                        "%s{\"name\":\"%s\",\"start\":%" PRIu32 ",\"end\":%" PRIu32 ",\"ok\":%s}",
+                        first ? "" : ",", phases[i].name, phases[i].start_ms, phases[i].end_ms,
+                        phases[i].ok ? "true" : "false");
+        first = false;
+    }
+    if (len >= 0 && (size_t)len < size) {
+        len += snprintf(buf + len, size - (size_t)len, "]}");
+    }
+    if (len < 0 || (size_t)len >= size) {
+        return -1;
+    }
+
+    return len;
+}
+
+static int append_heap(char *buf, size_t size, int len, const char *sep, const char *name,
+                       const heap_metrics_t *heap)
+{
+    if (len < 0 || (size_t)len >= size) {
+        return len;
+    }
+    return len + snprintf(buf + len, size - (size_t)len, "%s\"%s\":[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "]",
+                          sep, name, heap->free, heap->min_free, heap->largest);
+}
+
+/**
+ * @brief Format runtime metrics as compact JSON into a caller provided buffer
+ *
+ * @return Length of the message on success, -1 on error.
+ */
+int format_system_metrics(char *buf, size_t size, const char *id, const system_metrics_t *metrics)
+{
+    if (!buf || !id || !metrics) {
+        return -1;
+    }
+
+    int len = snprintf(buf, size, "{\"id\":\"%s\",\"up\":%" PRIu32 ",\"rssi\":%d,\"heap\":{",
+                       id, metrics->uptime_s, metrics->rssi);
+    len = append_heap(buf, size, len, "", "int", &metrics->heap_internal);
+    len = append_heap(buf, size, len, ",", "dma", &metrics->heap_dma);
+    if (metrics->has_spiram) {
+        len = append_heap(buf, size, len, ",", "spiram", &metrics->heap_spiram);
+    }
+    if (len >= 0 && (size_t)len < size) {
+        len += snprintf(buf + len, size - (size_t)len, "},\"ntask\":%" PRIu32 ",\"tasks\":[",
+                        metrics->total_tasks);
+    }
+
+    for (size_t i = 0; i < metrics->task_count && len >= 0 && (size_t)len < size; i++) {
+        const task_metrics_t *task = &metrics->tasks[i];
+        len += snprintf(buf + len, size - (size_t)len, "%s[\"%s\",%u,%" PRIu32 "]",
+                        i == 0 ? "" : ",", task->name, (unsigned)task->cpu_permille, task->stack_free);
+    }
+    if (len >= 0 && (size_t)len < size) {
+        len += snprintf(buf + len, size - (size_t)len, "]}");
+    }
+    if (len < 0 || (size_t)len >= size) {
+        return -1;
+    }
+
+    return len;
+}
@@ -1,6 +1,13 @@
 #ifndef MESSAGE_FORMATTER_H
 #define MESSAGE_FORMATTER_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_sample.h"
+#include "boot_phase.h"
+#include "system_metrics.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -12,6 +19,7 @@ extern "C" {
  * {
  *   "id": "device_id",
  *   "sensor": "sensor_type",  // optional
+ *   "period_ms": 10000,       // optional, current sampling period
  *   "data": {
  *     "temperature": {"value": "23.4", "unit": "C"},  // optional
  *     "humidity": {"value": "65.2", "unit": "%"},     // optional
@@ -19,20 +27,122 @@ extern "C" {
  *   }
  * }
  *
+ * Values are converted from the fixed-point sample with integer math only.
  * Returns dynamically allocated string containing JSON message.
  *
- * @param id          NUL-terminated device ID string (required, e.g. "28AB3E6B00000098")
- * @param sensor      NUL-terminated sensor type string (optional, can be NULL, e.g. "DS18B20")
- * @param temperature Temperature value in Celsius (optional, can be NULL)
- * @param humidity    Humidity value in percent (optional, can be NULL)
- * @param voltage     Voltage value in Volts (optional, can be NULL)
+ * @param sample Sample to format; id is required, fields selects the
+ *               measurements present
  * @return Allocated JSON string on success (caller MUST free()),
  *         NULL on error (invalid arguments or allocation failure).
  *
  * @note At least one measurement (temperature, humidity, or voltage) should be provided.
  * @note The returned string must be freed by the caller using free().
  */
-char *format_message(const char *id, const char *sensor, float *temperature, float *humidity, float *voltage);
+char *format_message(const sensor_sample_t *sample);
+
+/**
+ * @brief Format alarm message as JSON into a caller provided buffer
+ *
+ * Creates a JSON message in the following format:
+ * {
+ *   "id": "device_id",
+ *   "sensor": "DS18B20",
+ *   "alarm": "high",
+ *   "state": "active",          // or "cleared"
+ *   "value": "61.25",
+ *   "threshold": "60.00",
+ *   "ts": 123456                // milliseconds since boot
+ * }
+ *
+ * Does not allocate memory and uses integer formatting only, so it can be
+ * used on the alarm path right after a sample is read.
+ *
+ * @param buf       Output buffer
+ * @param size      Size of the output buffer
+ * @param id        NUL-terminated device ID string (required)
+ * @param sensor    NUL-terminated sensor name (required)
+ * @param alarm     NUL-terminated alarm rule name (required)
+ * @param active    true if the alarm is raised, false if cleared
+ * @param value     Value that changed the alarm state, scaled by 10^decimals
+ * @param threshold Rule threshold, scaled by 10^decimals
+ * @param decimals  Number of fraction digits of value and threshold
+ * @param ts_ms     Timestamp in milliseconds
+ * @return Length of the message on success, -1 if arguments are invalid or the buffer is too small
+ */
+int format_alarm_message(char *buf, size_t size, const char *id, const char *sensor, const char *alarm,
+                         bool active, int32_t value, int32_t threshold, int decimals, uint32_t ts_ms);
+
+/**
+ * @brief Format duty-cycle power report as JSON into a caller provided buffer
+ *
+ * Creates a JSON message in the following format:
+ * {
+ *   "id": "device_id",
+ *   "wake": 42,                 // wakes from deep sleep since cold boot
+ *   "awake_ms": 3120,           // wake-to-sleep time of the previous cycle
+ *   "current_ua": 152           // estimated average current in µA
+ * }
+ *
+ * @param buf           Output buffer
+ * @param size          Size of the output buffer
+ * @param id            NUL-terminated device ID string (required)
+ * @param wake_count    Number of wakes since cold boot
+ * @param awake_ms      Wake-to-sleep time of the previous cycle
+ * @param avg_current_ua Estimated average current in µA
+ * @return Length of the message on success, -1 if arguments are invalid or the buffer is too small
+ */
+int format_power_report(char *buf, size_t size, const char *id, uint32_t wake_count, uint32_t awake_ms,
+                        uint32_t avg_current_ua);
+
+/**
+ * @brief Format boot timeline as JSON into a caller provided buffer
+ *
+ * Creates a JSON message in the following format:
+ * {
+ *   "id": "device_id",
+ *   "boot_ms": 4210,            // boot finished, ms since app start
+ *   "phases": [
+ *     {"name": "wifi", "start": 12, "end": 95, "ok": true},
+ *     ...
+ *   ]
+ * }
+ *
+ * Phases without a name (not run) are left out.
+ *
+ * @param buf     Output buffer
+ * @param size    Size of the output buffer
+ * @param id      NUL-terminated device ID string (required)
+ * @param phases  Boot phases
+ * @param count   Number of phases
+ * @param boot_ms Time the boot finished
+ * @return Length of the message on success, -1 if arguments are invalid or the buffer is too small
+ */
+int format_boot_timeline(char *buf, size_t size, const char *id, const boot_phase_t *phases, size_t count,
+                         uint32_t boot_ms);
+
+/**
+ * @brief Format runtime metrics as compact JSON into a caller provided buffer
+ *
+ * Heap entries are [free, min_free, largest] in bytes, task entries are
+ * [name, cpu share in 0.1 %, free stack in bytes]:
+ * {
+ *   "id": "device_id",
+ *   "up": 3600,                 // uptime in s
+ *   "rssi": -61,                // dBm, 0 if not associated
+ *   "heap": {"int": [...], "dma": [...], "spiram": [...]},
+ *   "ntask": 14,                // tasks running
+ *   "tasks": [["main", 12, 1840], ...]
+ * }
+ *
+ * "spiram" is present only with external RAM.
+ *
+ * @param buf     Output buffer
+ * @param size    Size of the output buffer
+ * @param id      NUL-terminated device ID string (required)
+ * @param metrics Metrics snapshot
+ * @return Length of the message on success, -1 if arguments are invalid or the buffer is too small
+ */
+int format_system_metrics(char *buf, size_t size, const char *id, const system_metrics_t *metrics);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,81 @@
+#include "message_reassembler.h"
+#include <string.h>
+
+void message_reassembler_init(message_reassembler_t *reassembler, char *arena, size_t arena_size)
+{
+    memset(reassembler, 0, sizeof(*reassembler));
+    reassembler->arena = arena;
+    reassembler->arena_size = arena_size;
+}
+
+static message_reassembler_result_t drop_message(message_reassembler_t *reassembler, bool last_chunk)
+{
+    reassembler->active = false;
+    reassembler->discarding = !last_chunk;
+    reassembler->dropped++;
+    return MESSAGE_REASSEMBLER_DROPPED;
+}
+
+message_reassembler_result_t message_reassembler_feed(message_reassembler_t *reassembler,
+                                                      const char *topic, size_t topic_len,
+                                                      const char *data, size_t data_len,
+                                                      size_t offset, size_t total_len)
+{
+    bool last_chunk = (offset + data_len >= total_len);
+
+    if (offset == 0) {
+        // Start of a new message, an unfinished previous one is lost
+        if (reassembler->active) {
+            reassembler->dropped++;
+        }
+        reassembler->active = false;
+        reassembler->discarding = false;
+
+        // Topic + payload + NUL terminator must fit into the arena
+        if (topic_len == 0 || topic_len + total_len + 1 > reassembler->arena_size) {
+            return drop_message(reassembler, last_chunk);
+        }
+
+        memcpy(reassembler->arena, topic, topic_len);
+        reassembler->topic_len = topic_len;
+        reassembler->total_len = total_len;
+        reassembler->received = 0;
+        reassembler->active = true;
+    } else if (reassembler->discarding) {
+        // Remaining chunks of an already dropped message
+        if (last_chunk) {
+            reassembler->discarding = false;
+        }
+        return MESSAGE_REASSEMBLER_DROPPED;
+    } else if (!reassembler->active) {
+        // Continuation without a start, nothing to attach it to
+        return MESSAGE_REASSEMBLER_DROPPED;
+    }
+
+    if (offset != reassembler->received || total_len != reassembler->total_len ||
+        offset + data_len > reassembler->total_len) {
+        return drop_message(reassembler, last_chunk);
+    }
+
+    memcpy(reassembler->arena + reassembler->topic_len + offset, data, data_len);
+    reassembler->received += data_len;
+
+    if (reassembler->received < reassembler->total_len) {
+        return MESSAGE_REASSEMBLER_INCOMPLETE;
+    }
+
+    reassembler->arena[reassembler->topic_len + reassembler->total_len] = '\0';
+    reassembler->active = false;
+    reassembler->completed++;
+    return MESSAGE_REASSEMBLER_COMPLETE;
+}
+
+void message_reassembler_get(const message_reassembler_t *reassembler,
+                             const char **topic, size_t *topic_len,
+                             const char **data, size_t *data_len)
+{
+    *topic = reassembler->arena;
+    *topic_len = reassembler->topic_len;
+    *data = reassembler->arena + reassembler->topic_len;
+    *data_len = reassembler->total_len;
+}
@@ -0,0 +1,91 @@
+#ifndef MESSAGE_REASSEMBLER_H
+#define MESSAGE_REASSEMBLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Result of feeding one chunk to the reassembler
+ */
+typedef enum {
+    MESSAGE_REASSEMBLER_INCOMPLETE = 0,  // Chunk stored, more chunks expected
+    MESSAGE_REASSEMBLER_COMPLETE,        // Message complete, see message_reassembler_get()
+    MESSAGE_REASSEMBLER_DROPPED,         // Chunk dropped (oversized or out of sequence message)
+} message_reassembler_result_t;
+
+/**
+ * @brief Reassembly state of inbound messages
+ *
+ * Works on a caller provided arena that holds the topic followed by the
+ * payload of the message being reassembled. Only one message can be in
+ * flight at a time, which matches how the MQTT client delivers chunks.
+ * Never allocates memory.
+ */
+typedef struct {
+    char *arena;
+    size_t arena_size;
+    size_t topic_len;
+    size_t total_len;
+    size_t received;
+    bool active;            // Message in progress
+    bool discarding;        // Skipping the remaining chunks of a dropped message
+    uint32_t dropped;       // Number of dropped messages
+    uint32_t completed;     // Number of reassembled messages
+} message_reassembler_t;
+
+/**
+ * @brief Initialize reassembler on a preallocated arena
+ *
+ * @param reassembler Reassembler state
+ * @param arena       Buffer for topic and payload of one message
+ * @param arena_size  Size of the buffer; the largest accepted message is
+ *                    arena_size - topic length - 1 bytes
+ */
+void message_reassembler_init(message_reassembler_t *reassembler, char *arena, size_t arena_size);
+
+/**
+ * @brief Feed one received chunk
+ *
+ * The first chunk of a message must have offset 0 and carry the topic,
+ * following chunks may have an empty topic.
+ *
+ * @param reassembler Reassembler state
+ * @param topic       Topic of the message (first chunk only)
+ * @param topic_len   Topic length
+ * @param data        Chunk data
+ * @param data_len    Chunk length
+ * @param offset      Offset of the chunk within the message
+ * @param total_len   Total message length
+ * @return Result of the feed, see message_reassembler_result_t
+ */
+message_reassembler_result_t message_reassembler_feed(message_reassembler_t *reassembler,
+                                                      const char *topic, size_t topic_len,
+                                                      const char *data, size_t data_len,
+                                                      size_t offset, size_t total_len);
+
+/**
+ * @brief Get the last completed message
+ *
+ * Valid after message_reassembler_feed() returned COMPLETE and until the
+ * next chunk is fed. The payload is NUL-terminated for convenience.
+ *
+ * @param reassembler Reassembler state
+ * @param topic       Topic of the message (not NUL-terminated)
+ * @param topic_len   Topic length
+ * @param data        Payload of the message
+ * @param data_len    Payload length
+ */
+void message_reassembler_get(const message_reassembler_t *reassembler,
+                             const char **topic, size_t *topic_len,
+                             const char **data, size_t *data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MESSAGE_REASSEMBLER_H
@@ -0,0 +1,105 @@
+#include "message_spool.h"
+#include <string.h>
+
+/**
+ * @brief Record header, stored unaligned in front of topic and payload
+ */
+typedef struct {
+    uint16_t topic_len;
+    uint16_t payload_len;
+    uint8_t qos;
+    uint8_t retain;
+} spool_header_t;
+
+// Records are padded so headers stay word aligned
+#define SPOOL_ALIGN 4
+
+static size_t record_size(size_t topic_len, size_t payload_len)
+{
+    size_t size = sizeof(spool_header_t) + topic_len + 1 + payload_len + 1;
+    return (size + SPOOL_ALIGN - 1) & ~(size_t)(SPOOL_ALIGN - 1);
+}
+
+static spool_header_t read_header(const message_spool_t *spool, size_t offset)
+{
+    spool_header_t header;
+    memcpy(&header, spool->arena + offset, sizeof(header));
+    return header;
+}
+
+void message_spool_init(message_spool_t *spool, void *arena, size_t arena_size)
+{
+    memset(spool, 0, sizeof(*spool));
+    spool->arena = (uint8_t *)arena;
+    spool->arena_size = arena_size;
+}
+
+bool message_spool_push(message_spool_t *spool, const char *topic, const char *payload, int qos, bool retain)
+{
+    size_t topic_len = strlen(topic);
+    size_t payload_len = strlen(payload);
+
+    if (topic_len > UINT16_MAX || payload_len > UINT16_MAX ||
+        record_size(topic_len, payload_len) > spool->arena_size) {
+        spool->dropped++;
+        return false;
+    }
+
+    size_t size = record_size(topic_len, payload_len);
+    while (spool->arena_size - spool->tail < size) {
+        if (spool->head > 0) {
+            // Move the queued records to the start of the arena
+            memmove(spool->arena, spool->arena + spool->head, spool->tail - spool->head);
+            spool->tail -= spool->head;
+            spool->head = 0;
+        } else {
+            message_spool_pop(spool);
+            spool->dropped++;
+        }
+    }
+
+    spool_header_t header = {
+        .topic_len = (uint16_t)topic_len,
+        .payload_len = (uint16_t)payload_len,
+        .qos = (uint8_t)qos,
+        .retain = retain,
+    };
+    uint8_t *record = spool->arena + spool->tail;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), topic, topic_len + 1);
+    memcpy(record + sizeof(header) + topic_len + 1, payload, payload_len + 1);
+
+    spool->tail += size;
+    spool->count++;
+    return true;
+}
+
+bool message_spool_peek(const message_spool_t *spool, message_spool_entry_t *entry)
+{
+    if (spool->count == 0) {
+        return false;
+    }
+
+    spool_header_t header = read_header(spool, spool->head);
+    const char *topic = (const char *)spool->arena + spool->head + sizeof(header);
+    entry->topic = topic;
+    entry->payload = topic + header.topic_len + 1;
+    entry->qos = header.qos;
+    entry->retain = header.retain != 0;
+    return true;
+}
+
+void message_spool_pop(message_spool_t *spool)
+{
+    if (spool->count == 0) {
+        return;
+    }
+
+    spool_header_t header = read_header(spool, spool->head);
+    spool->head += record_size(header.topic_len, header.payload_len);
+    spool->count--;
+    if (spool->count == 0) {
+        spool->head = 0;
+        spool->tail = 0;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef MESSAGE_SPOOL_H
+#define MESSAGE_SPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief FIFO of outbound messages held while the broker is unreachable
+ *
+ * Works on a caller provided arena that holds the queued records back to
+ * back, each one a header followed by the NUL-terminated topic and
+ * payload. When a new message does not fit, the oldest messages are
+ * dropped to make room. Never allocates memory and is not thread safe.
+ */
+typedef struct {
+    uint8_t *arena;
+    size_t arena_size;
+    size_t head;            // Offset of the oldest record
+    size_t tail;            // Offset past the newest record
+    uint32_t count;         // Number of queued messages
+    uint32_t dropped;       // Number of messages dropped for lack of space
+} message_spool_t;
+
+/**
+ * @brief Queued message, pointers into the arena
+ */
+typedef struct {
+    const char *topic;
+    const char *payload;
+    uint8_t qos;
+    bool retain;
+} message_spool_entry_t;
+
+/**
+ * @brief Initialize spool on a preallocated arena
+ *
+ * @param spool      Spool state
+ * @param arena      Buffer for the queued records
+ * @param arena_size Size of the buffer
+ */
+void message_spool_init(message_spool_t *spool, void *arena, size_t arena_size);
+
+/**
+ * @brief Append a message, dropping the oldest ones if the arena is full
+ *
+ * @param spool   Spool state
+ * @param topic   NUL-terminated topic
+ * @param payload NUL-terminated payload
+ * @param qos     MQTT qos
+ * @param retain  Retain flag
+ * @return true if queued, false if the message alone is larger than the arena
+ */
+bool message_spool_push(message_spool_t *spool, const char *topic, const char *payload, int qos, bool retain);
+
+/**
+ * @brief Get the oldest message without removing it
+ *
+ * The entry is valid until the next push or pop.
+ *
+ * @param spool Spool state
+ * @param entry Receives the message
+ * @return true if a message is queued
+ */
+bool message_spool_peek(const message_spool_t *spool, message_spool_entry_t *entry);
+
+/**
+ * @brief Remove the oldest message
+ *
+ * @param spool Spool state
+ */
+void message_spool_pop(message_spool_t *spool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MESSAGE_SPOOL_H
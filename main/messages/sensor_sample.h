@@ -0,0 +1,37 @@
+#ifndef SENSOR_SAMPLE_H
+#define SENSOR_SAMPLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fields present in a sensor_sample_t
+ */
+#define SENSOR_SAMPLE_TEMPERATURE   (1u << 0)
+#define SENSOR_SAMPLE_HUMIDITY      (1u << 1)
+#define SENSOR_SAMPLE_VOLTAGE       (1u << 2)
+
+/**
+ * @brief Fixed-point sensor sample
+ *
+ * Used from the sensor managers to the serializer so the FPU-less
+ * ESP32-C3 never needs soft-float on the sample path.
+ */
+typedef struct {
+    const char *id;         // Device ID string (required)
+    const char *sensor;     // Sensor type string (optional, can be NULL)
+    uint32_t period_ms;     // Current sampling period (0 to omit)
+    uint32_t fields;        // SENSOR_SAMPLE_* bitmask of valid values
+    int32_t temperature;    // 0.01 °C (centi-degC)
+    int32_t humidity;       // 0.1 %RH (per-mille)
+    int32_t voltage;        // mV
+} sensor_sample_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_SAMPLE_H
@@ -0,0 +1,53 @@
+#ifndef SYSTEM_METRICS_H
+#define SYSTEM_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks reported per sample, further tasks are only counted
+#define SYSTEM_METRICS_MAX_TASKS    24
+#define SYSTEM_METRICS_NAME_SIZE    16
+
+/**
+ * @brief Runtime metrics of one task
+ */
+typedef struct {
+    char name[SYSTEM_METRICS_NAME_SIZE];
+    uint16_t cpu_permille;      // CPU share since the previous sample, 0.1 %
+    uint32_t stack_free;        // Stack high-water mark, bytes never used
+} task_metrics_t;
+
+/**
+ * @brief Heap state of one capability class
+ */
+typedef struct {
+    uint32_t free;              // Free bytes
+    uint32_t min_free;          // Lowest free bytes since boot
+    uint32_t largest;           // Largest free block
+} heap_metrics_t;
+
+/**
+ * @brief Snapshot of task, heap and Wi-Fi metrics
+ */
+typedef struct {
+    uint32_t uptime_s;
+    int8_t rssi;                // dBm, 0 if not associated
+    heap_metrics_t heap_internal;
+    heap_metrics_t heap_dma;
+    bool has_spiram;
+    heap_metrics_t heap_spiram;
+    uint32_t total_tasks;       // Tasks running, may exceed task_count
+    size_t task_count;          // Entries in tasks, 0 without run-time stats
+    task_metrics_t tasks[SYSTEM_METRICS_MAX_TASKS];
+} system_metrics_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSTEM_METRICS_H
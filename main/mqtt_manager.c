@@ -1,18 +1,28 @@
 #include "mqtt_manager.h"
 #include "esp_log.h"
 #include "esp_event.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "mqtt_client.h"
 #include "esp_err.h"
 #include "cert/cert.h"
+#include "messages/message_reassembler.h"
+#include "messages/message_spool.h"
+#include "trace_manager.h"
 #include "sdkconfig.h"
 #include <inttypes.h>
-#include "esp_netif_types.h"
+#include "esp_netif.h"
 #include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "mqtt_manager";
+
+ESP_EVENT_DEFINE_BASE(MQTT_MANAGER_EVENT);
+
 static EventGroupHandle_t network_event_group = NULL;
 static const int CONNECTED_BIT = BIT0;
+static const int MQTT_CONNECTED_BIT = BIT1;
 static const int subscribe_qos = 1;
 
 static const char **subscribe_topics = NULL;
@@ -20,6 +30,32 @@ static size_t subscribe_topic_count = 0;
 
 /* store mqtt client handle for publish / subscribe helpers */
 static esp_mqtt_client_handle_t s_mqtt_client = NULL;
+static bool s_client_started = false;
+static portMUX_TYPE s_start_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define MQTT_MAX_HANDLERS 4
+
+/* topic handlers for received messages */
+typedef struct {
+    const char *topic;
+    mqtt_message_handler_t handler;
+} mqtt_topic_handler_t;
+
+static mqtt_topic_handler_t s_handlers[MQTT_MAX_HANDLERS];
+static size_t s_handler_count = 0;
+
+/* reassembly of messages split over several MQTT_EVENT_DATA events */
+static char s_rx_arena[CONFIG_MQTT_RX_ARENA_SIZE];
+static message_reassembler_t s_reassembler;
+
+/*
+ * messages published while not connected, sent in order on connect.
+ * The MQTT task takes s_spool_lock while it holds the client API lock, so
+ * other tasks must not call into the client while holding s_spool_lock.
+ */
+static uint8_t s_spool_arena[CONFIG_MQTT_OFFLINE_BUFFER_SIZE];
+static message_spool_t s_spool;
+static SemaphoreHandle_t s_spool_lock = NULL;
 
 /* subscribe single topic  */
 static esp_err_t mqtt_manager_subscribe(esp_mqtt_client_handle_t client, const char *topic)
@@ -61,6 +97,110 @@ static esp_err_t mqtt_manager_subscribe_many(esp_mqtt_client_handle_t client, co
     return ESP_OK;
 }
 
+/* dispatch complete message to the handler registered for its topic */
+static void mqtt_manager_dispatch(const char *topic, size_t topic_len, const char *data, size_t data_len)
+{
+    for (size_t i = 0; i < s_handler_count; ++i) {
+        const char *handler_topic = s_handlers[i].topic;
+        if (strlen(handler_topic) == topic_len && memcmp(handler_topic, topic, topic_len) == 0) {
+            s_handlers[i].handler(topic, topic_len, data, data_len);
+            return;
+        }
+    }
+
+    ESP_LOGW(TAG, "No handler for topic %.*s", (int)topic_len, topic);
+}
+
+/* handle one MQTT_EVENT_DATA, which may be only a chunk of a larger message */
+static void mqtt_manager_handle_data(esp_mqtt_event_handle_t event)
+{
+    /* single chunk messages are dispatched straight from the client buffer */
+    if (event->current_data_offset == 0 && event->data_len == event->total_data_len) {
+        mqtt_manager_dispatch(event->topic, (size_t)event->topic_len, event->data, (size_t)event->data_len);
+        return;
+    }
+
+    message_reassembler_result_t result = message_reassembler_feed(&s_reassembler,
+        event->topic, (size_t)event->topic_len, event->data, (size_t)event->data_len,
+        (size_t)event->current_data_offset, (size_t)event->total_data_len);
+
+    switch (result) {
+        case MESSAGE_REASSEMBLER_COMPLETE: {
+            const char *topic;
+            const char *data;
+            size_t topic_len;
+            size_t data_len;
+
+            message_reassembler_get(&s_reassembler, &topic, &topic_len, &data, &data_len);
+            ESP_LOGI(TAG, "Reassembled %zu byte message on %.*s", data_len, (int)topic_len, topic);
+            mqtt_manager_dispatch(topic, topic_len, data, data_len);
+            break;
+        }
+        case MESSAGE_REASSEMBLER_DROPPED:
+            if (event->current_data_offset == 0) {
+                ESP_LOGW(TAG, "Dropped %d byte message (arena %d bytes), %" PRIu32 " dropped so far",
+                         event->total_data_len, CONFIG_MQTT_RX_ARENA_SIZE, s_reassembler.dropped);
+            }
+            break;
+        case MESSAGE_REASSEMBLER_INCOMPLETE:
+        default:
+            break;
+    }
+}
+
+/* start the client once the station has an address, it reconnects on its own afterwards */
+static void mqtt_manager_start_client(void)
+{
+    /* IP event and mqtt_init() may race, start only once */
+    taskENTER_CRITICAL(&s_start_lock);
+    bool start = !s_client_started && s_mqtt_client;
+    s_client_started |= start;
+    taskEXIT_CRITICAL(&s_start_lock);
+    if (!start) {
+        return;
+    }
+
+    esp_err_t err = esp_mqtt_client_start(s_mqtt_client);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "MQTT client started");
+    } else {
+        ESP_LOGE(TAG, "Failed to start MQTT client: %s", esp_err_to_name(err));
+        taskENTER_CRITICAL(&s_start_lock);
+        s_client_started = false;
+        taskEXIT_CRITICAL(&s_start_lock);
+    }
+}
+
+/* send the messages buffered while offline, the caller holds s_spool_lock */
+static void mqtt_manager_send_spooled(esp_mqtt_client_handle_t client)
+{
+    uint32_t sent = 0;
+    message_spool_entry_t entry;
+
+    while (message_spool_peek(&s_spool, &entry)) {
+        int len = (int)strlen(entry.payload);
+        if (esp_mqtt_client_publish(client, entry.topic, entry.payload, len, entry.qos, entry.retain) < 0) {
+            ESP_LOGW(TAG, "Failed to send buffered message to %s", entry.topic);
+        } else {
+            sent++;
+        }
+        message_spool_pop(&s_spool);
+    }
+
+    if (sent > 0 || s_spool.dropped > 0) {
+        ESP_LOGI(TAG, "Sent %" PRIu32 " buffered messages, %" PRIu32 " dropped while offline",
+                 sent, s_spool.dropped);
+    }
+    s_spool.dropped = 0;
+}
+
+static void mqtt_manager_post_event(mqtt_manager_event_t event)
+{
+    if (esp_event_post(MQTT_MANAGER_EVENT, event, NULL, 0, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to post connection event %d", event);
+    }
+}
+
 /**
  * @brief Handle IP events.
  *
@@ -80,6 +220,7 @@ static void ip_event_handler(void* arg, esp_event_base_t event_base,
     switch (event_id) {
         case IP_EVENT_STA_GOT_IP:
             xEventGroupSetBits(network_event_group, CONNECTED_BIT);
+            mqtt_manager_start_client();
             break;
         case IP_EVENT_STA_LOST_IP:
             xEventGroupClearBits(network_event_group, CONNECTED_BIT);
@@ -108,16 +249,27 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
             ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED");
             if (subscribe_topics && subscribe_topic_count > 0)
                 mqtt_manager_subscribe_many(client, subscribe_topics, subscribe_topic_count);
+            for (size_t i = 0; i < s_handler_count; ++i)
+                mqtt_manager_subscribe(client, s_handlers[i].topic);
 
+            /* buffered messages go out before any new one, this task already holds the client lock */
+            xSemaphoreTake(s_spool_lock, portMAX_DELAY);
+            mqtt_manager_send_spooled(client);
+            xEventGroupSetBits(network_event_group, MQTT_CONNECTED_BIT);
+            xSemaphoreGive(s_spool_lock);
+            mqtt_manager_post_event(MQTT_MANAGER_EVENT_CONNECTED);
             break;
         case MQTT_EVENT_DATA:
-            ESP_LOGI(TAG, "MQTT_EVENT_DATA: TOPIC=%.*s DATA=%.*s",
-                     event->topic_len, event->topic,
-                     event->data_len, event->data);
+            ESP_LOGD(TAG, "MQTT_EVENT_DATA: TOPIC=%.*s offset=%d len=%d total=%d",
+                     event->topic_len, event->topic, event->current_data_offset,
+                     event->data_len, event->total_data_len);
+            TRACE(TRACE_EVENT_MQTT_DATA, event->data_len, event->total_data_len);
+            mqtt_manager_handle_data(event);
             break;
         case MQTT_EVENT_DISCONNECTED:
-            ESP_LOGI(TAG, "MQTT_EVENT_DISCONNECTED");
-            esp_restart();
+            ESP_LOGI(TAG, "MQTT_EVENT_DISCONNECTED, buffering until reconnected");
+            xEventGroupClearBits(network_event_group, MQTT_CONNECTED_BIT);
+            mqtt_manager_post_event(MQTT_MANAGER_EVENT_DISCONNECTED);
             break;
         case MQTT_EVENT_SUBSCRIBED:
             ESP_LOGI(TAG, "MQTT_EVENT_SUBSCRIBED, msg_id=%d", event->msg_id);
@@ -126,7 +278,9 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
             ESP_LOGI(TAG, "MQTT_EVENT_UNSUBSCRIBED, msg_id=%d", event->msg_id);
             break;
         case MQTT_EVENT_PUBLISHED:
-            ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
+            /* once per QoS 1 message, traced instead of logged */
+            TRACE(TRACE_EVENT_MQTT_PUBLISHED, event->msg_id, 0);
+            ESP_LOGD(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
             break;
         case MQTT_EVENT_ERROR:
             ESP_LOGE(TAG, "MQTT disconnected with return code %d", event->error_handle->connect_return_code);
@@ -138,13 +292,35 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
                 if (event->error_handle->esp_transport_sock_errno)
                     ESP_LOGE(TAG, "socket transport reported error: 0x%x", event->error_handle->esp_transport_sock_errno);
             }
-            esp_restart();
+            /* the client reconnects on its own */
+            break;
         default:
             ESP_LOGI(TAG, "Other event id: %d", event->event_id);
             break;
     }
 }
 
+/**
+ * @brief Register handler for messages received on a topic.
+ */
+esp_err_t mqtt_manager_register_handler(const char *topic, mqtt_message_handler_t handler)
+{
+    if (!topic || !handler) {
+        ESP_LOGE(TAG, "Invalid arguments, topic or handler is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_handler_count >= MQTT_MAX_HANDLERS) {
+        ESP_LOGE(TAG, "Handler table full, cannot register %s", topic);
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_handlers[s_handler_count].topic = topic;
+    s_handlers[s_handler_count].handler = handler;
+    s_handler_count++;
+
+    return ESP_OK;
+}
+
 /**
  * @brief Publish wrapper using stored client handle.
  */
@@ -154,8 +330,29 @@ int mqtt_manager_publish(const char *topic, const char *payload, int qos, bool r
         ESP_LOGE(TAG, "mqtt_manager_publish: client not ready or args NULL");
         return -1;
     }
+
+    xSemaphoreTake(s_spool_lock, portMAX_DELAY);
+    if (!(xEventGroupGetBits(network_event_group) & MQTT_CONNECTED_BIT)) {
+        bool queued = message_spool_push(&s_spool, topic, payload, qos, retain);
+        xSemaphoreGive(s_spool_lock);
+        if (!queued) {
+            ESP_LOGE(TAG, "Message for %s larger than the offline buffer", topic);
+            return -1;
+        }
+        ESP_LOGD(TAG, "Buffered message for %s until connected", topic);
+        TRACE(TRACE_EVENT_MQTT_PUBLISH, strlen(payload), 0);
+        return 0;
+    }
+
+    /*
+     * The connected bit is set after the spool was sent, so this message
+     * follows the buffered ones. Published without s_spool_lock, the MQTT
+     * task holding the client lock may be waiting for it.
+     */
+    xSemaphoreGive(s_spool_lock);
     int len = (int)strlen(payload);
     int msg_id = esp_mqtt_client_publish(s_mqtt_client, topic, payload, len, qos, retain);
+    TRACE(TRACE_EVENT_MQTT_PUBLISH, len, msg_id);
     if (msg_id >= 0) {
         ESP_LOGD(TAG, "Published to %s (len=%d) msg_id=%d", topic, len, msg_id);
     } else {
@@ -165,25 +362,79 @@ int mqtt_manager_publish(const char *topic, const char *payload, int qos, bool r
 }
 
 /**
- * @brief Initialize and start MQTT client.
- * Waits for WiFi connection before starting MQTT.
+ * @brief Check whether the client is connected to the broker.
+ */
+bool mqtt_manager_is_connected(void)
+{
+    return network_event_group && (xEventGroupGetBits(network_event_group) & MQTT_CONNECTED_BIT);
+}
+
+/**
+ * @brief Wait until the client is connected to the broker.
+ */
+esp_err_t mqtt_manager_wait_connected(uint32_t timeout_ms)
+{
+    if (!s_mqtt_client) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    EventBits_t bits = xEventGroupWaitBits(network_event_group, MQTT_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & MQTT_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+/* number of messages waiting in the offline buffer */
+static uint32_t mqtt_manager_spooled(void)
+{
+    xSemaphoreTake(s_spool_lock, portMAX_DELAY);
+    uint32_t count = s_spool.count;
+    xSemaphoreGive(s_spool_lock);
+    return count;
+}
+
+/**
+ * @brief Wait until all queued messages were acknowledged.
+ */
+esp_err_t mqtt_manager_flush(uint32_t timeout_ms)
+{
+    if (!s_mqtt_client) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (uint32_t waited = 0; esp_mqtt_client_get_outbox_size(s_mqtt_client) > 0 || mqtt_manager_spooled() > 0;
+         waited += 50) {
+        if (waited >= timeout_ms) {
+            ESP_LOGW(TAG, "%d bytes still in outbox, %" PRIu32 " messages not sent",
+                     esp_mqtt_client_get_outbox_size(s_mqtt_client), mqtt_manager_spooled());
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Initialize MQTT client, started in the background once WiFi has an IP.
  * @param topics Array of topic strings to subscribe.
  * @param topic_count Number of topics in the array.
  */
-void mqtt_init(const char *topics[], size_t topic_count)
+esp_err_t mqtt_init(const char *topics[], size_t topic_count)
 {
     /* store references */
     subscribe_topics = topics;
     subscribe_topic_count = topic_count;
 
+    message_reassembler_init(&s_reassembler, s_rx_arena, sizeof(s_rx_arena));
+    message_spool_init(&s_spool, s_spool_arena, sizeof(s_spool_arena));
+
     if (network_event_group == NULL) {
         network_event_group = xEventGroupCreate();
     }
-    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &ip_event_handler, NULL));
-
-    /* Wait for WiFi connection */
-    ESP_LOGI(TAG, "Waiting for WiFi connection...");
-    xEventGroupWaitBits(network_event_group, CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+    if (s_spool_lock == NULL) {
+        s_spool_lock = xSemaphoreCreateMutex();
+    }
+    if (network_event_group == NULL || s_spool_lock == NULL) {
+        ESP_LOGE(TAG, "Failed to create MQTT manager sync objects");
+        return ESP_ERR_NO_MEM;
+    }
 
     /* prepare last will payload (DISCONNECTED) */
     static char last_will_payload[128];
@@ -217,19 +468,24 @@ void mqtt_init(const char *topics[], size_t topic_count)
     esp_mqtt_client_handle_t client = esp_mqtt_client_init(&mqtt5_cfg);
     if (!client) {
         ESP_LOGE(TAG, "Failed to initialize MQTT client");
-        return;
+        return ESP_FAIL;
     }
 
-    /* store client handle for publish helpers */
+    /* store client handle for publish helpers, messages are buffered from now on */
     s_mqtt_client = client;
 
     esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &ip_event_handler, NULL));
 
-    esp_err_t err = esp_mqtt_client_start(client);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start MQTT client: %d", err);
-        s_mqtt_client = NULL;
-        return;
+    /* the station may have got its address before the handler was registered */
+    esp_netif_ip_info_t ip_info;
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (netif && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK && ip_info.ip.addr != 0) {
+        xEventGroupSetBits(network_event_group, CONNECTED_BIT);
+        mqtt_manager_start_client();
+    } else {
+        ESP_LOGI(TAG, "MQTT client starts once WiFi is connected");
     }
-    ESP_LOGI(TAG, "MQTT client started");
+
+    return ESP_OK;
 }
\ No newline at end of file
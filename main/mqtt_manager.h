@@ -2,32 +2,114 @@
 #define MQTT_MANAGER_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <esp_err.h>
+#include <esp_event.h>
 #include <stdbool.h>
 
 /**
- * @brief Initialize and start the MQTT manager.
+ * @brief Broker connection events, posted to the default event loop.
+ */
+ESP_EVENT_DECLARE_BASE(MQTT_MANAGER_EVENT);
+
+typedef enum {
+    MQTT_MANAGER_EVENT_CONNECTED,       /*!< Connected, messages buffered while offline were sent */
+    MQTT_MANAGER_EVENT_DISCONNECTED,    /*!< Connection lost, messages are buffered until reconnected */
+} mqtt_manager_event_t;
+
+/**
+ * @brief Handler for complete messages received on a subscribed topic.
  *
- * Creates and starts the MQTT client, waits for network if needed and
- * subscribes to topics provided in the topics array (the manager stores
- * the pointer for later use).
+ * Called from the MQTT client task once all chunks of a message arrived.
+ * Topic and data are not NUL-terminated and are only valid for the
+ * duration of the call.
+ *
+ * @param topic Topic the message was received on.
+ * @param topic_len Length of the topic.
+ * @param data Message payload.
+ * @param data_len Length of the payload.
+ */
+typedef void (*mqtt_message_handler_t)(const char *topic, size_t topic_len, const char *data, size_t data_len);
+
+/**
+ * @brief Initialize the MQTT manager.
+ *
+ * Creates the MQTT client and returns at once. The client is started in
+ * the background as soon as WiFi has an IP, reconnects on its own and
+ * subscribes to topics provided in the topics array on every connect (the
+ * manager stores the pointer for later use). Connection changes are
+ * posted as MQTT_MANAGER_EVENT events. Needs the default event loop.
  *
  * @param topics Array of topic strings to subscribe to.
  * @param topic_count Number of topics in the array.
+ * @return ESP_OK on success,
+ *         ESP_ERR_NO_MEM if the sync objects could not be created,
+ *         ESP_FAIL if the client could not be created.
+ */
+esp_err_t mqtt_init(const char *topics[], size_t topic_count);
+
+/**
+ * @brief Register handler for messages received on a topic.
+ *
+ * The topic is subscribed on every (re)connect and complete messages
+ * received on it are dispatched to the handler. Messages larger than the
+ * client buffer are reassembled in a preallocated arena of
+ * CONFIG_MQTT_RX_ARENA_SIZE bytes; larger messages are dropped.
+ * Should be called before mqtt_init() so no message is missed.
+ *
+ * @param topic Exact topic (no wildcards), must stay valid while registered.
+ * @param handler Handler function.
+ * @return ESP_OK on success,
+ *         ESP_ERR_INVALID_ARG if an argument is NULL,
+ *         ESP_ERR_NO_MEM if the handler table is full.
  */
-void mqtt_init(const char *topics[], size_t topic_count);
+esp_err_t mqtt_manager_register_handler(const char *topic, mqtt_message_handler_t handler);
 
 /**
  * @brief Publish payload to topic.
  *
  * Wrapper around esp_mqtt_client_publish using the mqtt_manager's client handle.
+ * While not connected the message is copied to an offline buffer of
+ * CONFIG_MQTT_OFFLINE_BUFFER_SIZE bytes and sent in order on connect; the
+ * oldest buffered messages are dropped when it is full.
  *
  * @param topic Full topic string to publish to (e.g. "/stochov/1.1/heating/state").
  * @param payload NUL-terminated payload string.
  * @param qos MQTT qos.
  * @param retain retain flag.
- * @return message id (>=0) on success, -1 on error (e.g. client not started).
+ * @return message id (>=0) on success, 0 if buffered, -1 on error
+ *         (e.g. mqtt_init() not called).
  */
 int mqtt_manager_publish(const char *topic, const char *payload, int qos, bool retain);
 
+/**
+ * @brief Check whether the client is connected to the broker.
+ */
+bool mqtt_manager_is_connected(void);
+
+/**
+ * @brief Wait until the client is connected to the broker.
+ *
+ * @param timeout_ms Maximum time to wait.
+ * @return ESP_OK when connected,
+ *         ESP_ERR_TIMEOUT if not connected within timeout_ms,
+ *         ESP_ERR_INVALID_STATE if the client was not started.
+ */
+esp_err_t mqtt_manager_wait_connected(uint32_t timeout_ms);
+
+/**
+ * @brief Wait until all messages in the outbox were acknowledged.
+ *
+ * QoS 0 messages are written to the socket by mqtt_manager_publish()
+ * already, this waits for QoS 1/2 messages still in flight and for
+ * messages in the offline buffer. Use it
+ * before shutting down, e.g. entering deep sleep.
+ *
+ * @param timeout_ms Maximum time to wait.
+ * @return ESP_OK when the outbox and the offline buffer are empty,
+ *         ESP_ERR_TIMEOUT if messages are left after timeout_ms,
+ *         ESP_ERR_INVALID_STATE if the client was not started.
+ */
+esp_err_t mqtt_manager_flush(uint32_t timeout_ms);
+
 #endif // MQTT_MANAGER_H
\ No newline at end of file
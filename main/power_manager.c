@@ -0,0 +1,126 @@
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_wifi.h"
+#include "sdkconfig.h"
+#include "power_manager.h"
+
+static const char *TAG = "power_manager";
+
+// Lowest CPU clock with frequency scaling, the XTAL frequency
+#define POWER_MIN_CPU_FREQ_MHZ 40
+
+/**
+ * @brief Settings of one power profile
+ */
+typedef struct {
+    const char *name;
+    bool scale_frequency;
+    bool light_sleep;
+    wifi_ps_type_t wifi_ps;
+    uint32_t idle_current_ua;
+} power_profile_desc_t;
+
+static const power_profile_desc_t profiles[POWER_PROFILE_COUNT] = {
+    [POWER_PROFILE_PERFORMANCE] = { "performance", false, false, WIFI_PS_NONE,
+                                    CONFIG_POWER_IDLE_CURRENT_PERFORMANCE_UA },
+    [POWER_PROFILE_BALANCED] = { "balanced", true, false, WIFI_PS_MIN_MODEM,
+                                 CONFIG_POWER_IDLE_CURRENT_BALANCED_UA },
+    [POWER_PROFILE_LOW_POWER] = { "low", true, true, WIFI_PS_MAX_MODEM,
+                                  CONFIG_POWER_IDLE_CURRENT_LOW_POWER_UA },
+};
+
+static power_profile_t active_profile = POWER_PROFILE_PERFORMANCE;
+static esp_pm_lock_handle_t timing_lock = NULL;
+
+esp_err_t power_manager_init(void)
+{
+#if CONFIG_PM_ENABLE
+    esp_err_t ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "timing", &timing_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PM lock: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_ENABLE is off, CPU clock stays fixed in all profiles");
+#endif
+    return ESP_OK;
+}
+
+esp_err_t power_manager_apply(power_profile_t profile)
+{
+    if (profile >= POWER_PROFILE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const power_profile_desc_t *desc = &profiles[profile];
+    esp_err_t ret = ESP_OK;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = desc->scale_frequency ? POWER_MIN_CPU_FREQ_MHZ : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = desc->light_sleep,
+#endif
+    };
+    ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure PM: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#endif
+
+    ret = esp_wifi_set_ps(desc->wifi_ps);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set Wi-Fi power save: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    active_profile = profile;
+    ESP_LOGI(TAG, "Power profile %s: frequency scaling %s, light sleep %s, idle current %" PRIu32 " uA",
+             desc->name, desc->scale_frequency ? "on" : "off", desc->light_sleep ? "on" : "off",
+             desc->idle_current_ua);
+    return ESP_OK;
+}
+
+power_profile_t power_manager_get_profile(void)
+{
+    return active_profile;
+}
+
+uint32_t power_manager_get_idle_current_ua(power_profile_t profile)
+{
+    return profile < POWER_PROFILE_COUNT ? profiles[profile].idle_current_ua : 0;
+}
+
+const char *power_manager_profile_name(power_profile_t profile)
+{
+    return profile < POWER_PROFILE_COUNT ? profiles[profile].name : "?";
+}
+
+bool power_manager_parse_profile(const char *name, size_t len, power_profile_t *profile)
+{
+    for (int i = 0; i < POWER_PROFILE_COUNT; i++) {
+        if (strlen(profiles[i].name) == len && memcmp(profiles[i].name, name, len) == 0) {
+            *profile = (power_profile_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void power_manager_lock_timing(void)
+{
+    if (timing_lock) {
+        esp_pm_lock_acquire(timing_lock);
+    }
+}
+
+void power_manager_unlock_timing(void)
+{
+    if (timing_lock) {
+        esp_pm_lock_release(timing_lock);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Power profiles, combination of CPU clock policy and Wi-Fi power save
+ */
+typedef enum {
+    POWER_PROFILE_PERFORMANCE = 0,  // Fixed maximum CPU clock, Wi-Fi power save off
+    POWER_PROFILE_BALANCED,         // Dynamic frequency scaling, Wi-Fi modem sleep
+    POWER_PROFILE_LOW_POWER,        // Frequency scaling with automatic light sleep, maximum modem sleep
+    POWER_PROFILE_COUNT
+} power_profile_t;
+
+/**
+ * @brief Create the PM lock used around timing-critical bus transfers
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t power_manager_init(void);
+
+/**
+ * @brief Apply a power profile
+ *
+ * Configures esp_pm and the Wi-Fi power save mode, so Wi-Fi must be
+ * initialized. Frequency scaling and light sleep need CONFIG_PM_ENABLE
+ * and CONFIG_FREERTOS_USE_TICKLESS_IDLE, without them only the Wi-Fi
+ * power save mode changes.
+ *
+ * @param profile Profile to apply
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown profile,
+ *         error code of esp_pm or esp_wifi otherwise
+ */
+esp_err_t power_manager_apply(power_profile_t profile);
+
+/**
+ * @brief Get the active power profile
+ */
+power_profile_t power_manager_get_profile(void);
+
+/**
+ * @brief Get the bench-measured idle current of a profile
+ *
+ * @param profile Profile
+ * @return Idle current in µA from Kconfig, 0 for an unknown profile
+ */
+uint32_t power_manager_get_idle_current_ua(power_profile_t profile);
+
+/**
+ * @brief Get the name of a profile ("performance", "balanced", "low")
+ */
+const char *power_manager_profile_name(power_profile_t profile);
+
+/**
+ * @brief Look up a profile by name
+ *
+ * @param name    Name (not NUL-terminated)
+ * @param len     Length of name
+ * @param profile Receives the profile
+ * @return true if the name is known
+ */
+bool power_manager_parse_profile(const char *name, size_t len, power_profile_t *profile);
+
+/**
+ * @brief Keep the CPU at full clock and out of light sleep
+ *
+ * Hold only around bit-banged or timing-critical bus transfers (1-Wire,
+ * DHT, I2C), never around waits. Calls nest.
+ */
+void power_manager_lock_timing(void);
+
+/**
+ * @brief Release power_manager_lock_timing()
+ */
+void power_manager_unlock_timing(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "sample_history.h"
+
+/**
+ * @brief History of one series, ring of closed buckets plus the open one
+ */
+typedef struct {
+    history_bucket_t buckets[HISTORY_BUCKETS];
+    uint8_t head;               // Index of the next bucket to write
+    uint8_t count;              // Number of valid closed buckets
+    uint32_t generation;        // Buckets closed since boot
+    bool open_valid;            // Open bucket has samples
+    uint32_t open_slot;         // Time slot (now_ms / HISTORY_BUCKET_MS) of the open bucket
+    int32_t open_min;
+    int32_t open_max;
+    int32_t open_sum;
+    uint16_t open_count;
+} history_state_t;
+
+static history_state_t history[HISTORY_SERIES_COUNT];
+static portMUX_TYPE history_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const series_names[HISTORY_SERIES_COUNT] = {
+    "DS18B20", "DHT22 T", "DHT22 H", "Voltage", "SHT3x T", "SHT3x H", "BME280 T", "BME280 H",
+};
+
+static int16_t clamp16(int32_t value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+static void push_bucket(history_state_t *state, const history_bucket_t *bucket)
+{
+    state->buckets[state->head] = *bucket;
+    state->head = (uint8_t)((state->head + 1) % HISTORY_BUCKETS);
+    if (state->count < HISTORY_BUCKETS) {
+        state->count++;
+    }
+    state->generation++;
+}
+
+static void open_to_bucket(const history_state_t *state, history_bucket_t *out)
+{
+    out->min = clamp16(state->open_min);
+    out->max = clamp16(state->open_max);
+    out->avg = clamp16(state->open_sum / (int32_t)state->open_count);
+}
+
+void sample_history_add(history_series_t series, int32_t value, uint32_t now_ms)
+{
+    if (series >= HISTORY_SERIES_COUNT) {
+        return;
+    }
+
+    history_state_t *state = &history[series];
+    uint32_t slot = now_ms / HISTORY_BUCKET_MS;
+
+    taskENTER_CRITICAL(&history_lock);
+
+    if (state->open_valid && slot != state->open_slot) {
+        history_bucket_t bucket;
+        open_to_bucket(state, &bucket);
+        push_bucket(state, &bucket);
+
+        // Slots without samples become empty buckets
+        const history_bucket_t empty = { .min = INT16_MAX, .max = INT16_MIN, .avg = 0 };
+        uint32_t gap = slot - state->open_slot - 1;
+        for (uint32_t i = 0; i < gap && i < HISTORY_BUCKETS; i++) {
+            push_bucket(state, &empty);
+        }
+        state->open_valid = false;
+    }
+
+    if (!state->open_valid) {
+        state->open_valid = true;
+        state->open_slot = slot;
+        state->open_min = value;
+        state->open_max = value;
+        state->open_sum = 0;
+        state->open_count = 0;
+    }
+
+    if (value < state->open_min) {
+        state->open_min = value;
+    }
+    if (value > state->open_max) {
+        state->open_max = value;
+    }
+    state->open_sum += value;
+    state->open_count++;
+
+    taskEXIT_CRITICAL(&history_lock);
+}
+
+size_t sample_history_read(history_series_t series, history_bucket_t *out, size_t max, uint32_t *generation)
+{
+    if (series >= HISTORY_SERIES_COUNT) {
+        return 0;
+    }
+
+    const history_state_t *state = &history[series];
+    size_t count;
+
+    taskENTER_CRITICAL(&history_lock);
+    count = state->count < max ? state->count : max;
+    for (size_t age = 0; age < count; age++) {
+        out[age] = state->buckets[(state->head + HISTORY_BUCKETS - 1 - age) % HISTORY_BUCKETS];
+    }
+    if (generation) {
+        *generation = state->generation;
+    }
+    taskEXIT_CRITICAL(&history_lock);
+
+    return count;
+}
+
+bool sample_history_get_open(history_series_t series, history_bucket_t *out)
+{
+    if (series >= HISTORY_SERIES_COUNT) {
+        return false;
+    }
+
+    const history_state_t *state = &history[series];
+    bool found = false;
+
+    taskENTER_CRITICAL(&history_lock);
+    if (state->open_valid) {
+        open_to_bucket(state, out);
+        found = true;
+    }
+    taskEXIT_CRITICAL(&history_lock);
+    return found;
+}
+
+bool sample_history_has_samples(history_series_t series)
+{
+    if (series >= HISTORY_SERIES_COUNT) {
+        return false;
+    }
+
+    const history_state_t *state = &history[series];
+    bool found;
+
+    taskENTER_CRITICAL(&history_lock);
+    found = state->generation > 0 || state->open_valid;
+    taskEXIT_CRITICAL(&history_lock);
+    return found;
+}
+
+const char *sample_history_series_name(history_series_t series)
+{
+    return series < HISTORY_SERIES_COUNT ? series_names[series] : "?";
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One hour of history in 30 s buckets
+#define HISTORY_BUCKETS         120
+#define HISTORY_BUCKET_MS       30000
+
+/**
+ * @brief Recorded sample series
+ *
+ * Units as in the sample pipeline: temperatures in 0.01 °C,
+ * humidity in 0.1 %RH and voltage in mV.
+ */
+typedef enum {
+    HISTORY_DS18B20_TEMP = 0,
+    HISTORY_DHT22_TEMP,
+    HISTORY_DHT22_HUMIDITY,
+    HISTORY_VOLTAGE,
+    HISTORY_SHT3X_TEMP,             // Optional I2C sensors, empty when absent
+    HISTORY_SHT3X_HUMIDITY,
+    HISTORY_BME280_TEMP,
+    HISTORY_BME280_HUMIDITY,
+    HISTORY_SERIES_COUNT
+} history_series_t;
+
+/**
+ * @brief Downsampled history bucket
+ *
+ * Values are clamped to int16_t. A bucket without samples has min > max.
+ */
+typedef struct {
+    int16_t min;
+    int16_t max;
+    int16_t avg;
+} history_bucket_t;
+
+/**
+ * @brief Add a sample to a series
+ *
+ * Samples are accumulated into the bucket of their time slot. The bucket
+ * is closed when the first sample of a later slot arrives, slots without
+ * samples are recorded as empty buckets.
+ *
+ * @param series Series
+ * @param value  Sample value
+ * @param now_ms Sample time in milliseconds
+ */
+void sample_history_add(history_series_t series, int32_t value, uint32_t now_ms);
+
+/**
+ * @brief Copy the newest closed buckets
+ *
+ * Buckets and generation are read atomically, so a reader can compare
+ * the generation with an earlier one to find out how many of the
+ * returned buckets are new.
+ *
+ * @param series     Series
+ * @param out        Destination, out[0] is the newest bucket
+ * @param max        Capacity of out
+ * @param generation Receives the number of buckets closed since boot (may be NULL)
+ * @return Number of buckets copied (empty buckets included)
+ */
+size_t sample_history_read(history_series_t series, history_bucket_t *out, size_t max, uint32_t *generation);
+
+/**
+ * @brief Get the bucket currently being accumulated
+ *
+ * @param series Series
+ * @param out    Destination of the bucket
+ * @return true if the open bucket has samples
+ */
+bool sample_history_get_open(history_series_t series, history_bucket_t *out);
+
+/**
+ * @brief Whether a series has recorded any sample since boot
+ *
+ * @param series Series
+ * @return true if a closed or the open bucket holds samples
+ */
+bool sample_history_has_samples(history_series_t series);
+
+/**
+ * @brief Get a short display name of a series
+ *
+ * @param series Series
+ * @return Name string
+ */
+const char *sample_history_series_name(history_series_t series);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "ds18b20_manager.h"
+#include "dht22_manager.h"
+#include "sht3x_manager.h"
+#include "bme280_manager.h"
+#include "adc_manager.h"
+#include "mqtt_manager.h"
+#include "alarm_manager.h"
+#include "sample_history.h"
+#include "trace_manager.h"
+#include "messages/message_formatter.h"
+#include "sample_pipeline.h"
+
+static const char *TAG = "sample_pipeline";
+
+/**
+ * @brief Deadband state of one published message stream
+ */
+typedef struct {
+    bool valid;
+    int32_t last[2];
+    uint32_t skipped;
+    uint32_t published;
+} publish_filter_t;
+
+// Deadband references and counters survive deep sleep in duty-cycle mode
+static RTC_DATA_ATTR publish_filter_t ds_filter;
+static RTC_DATA_ATTR publish_filter_t dht_filter;
+static RTC_DATA_ATTR publish_filter_t adc_filter;
+static RTC_DATA_ATTR publish_filter_t sht3x_filter;
+static RTC_DATA_ATTR publish_filter_t bme280_filter;
+
+static sample_clock_t clock_ms = NULL;
+static sample_listener_t sample_listener = NULL;
+
+// Held while a sensor is sampled, benchmarks take it for exclusive sensor access
+static SemaphoreHandle_t sensor_lock = NULL;
+static StaticSemaphore_t sensor_lock_buffer;
+
+/**
+ * @brief Decide whether a sample should be published
+ *
+ * A sample is published when any value moved by at least its deadband since
+ * the last published sample, or when heartbeat_cycles samples were skipped.
+ */
+static bool publish_filter_check(publish_filter_t *filter, const int32_t *values, const int32_t *deadbands,
+                                 size_t count, uint32_t heartbeat_cycles)
+{
+    bool publish = !filter->valid || filter->skipped >= heartbeat_cycles;
+
+    for (size_t i = 0; i < count && !publish; i++) {
+        int32_t delta = values[i] - filter->last[i];
+        if (delta < 0) {
+            delta = -delta;
+        }
+        publish = delta >= deadbands[i];
+    }
+
+    if (publish) {
+        memcpy(filter->last, values, count * sizeof(values[0]));
+        filter->valid = true;
+        filter->skipped = 0;
+        filter->published++;
+    } else {
+        filter->skipped++;
+    }
+    return publish;
+}
+
+static void notify_listener(sample_source_t source, const int32_t *values, size_t count)
+{
+    if (sample_listener) {
+        sample_listener(source, values, count);
+    }
+}
+
+/**
+ * @brief Read DS18B20, evaluate alarms and publish telemetry
+ */
+static void sample_ds18b20(const app_config_t *cfg)
+{
+    int32_t ds_centi = 0;
+    char rom_code_s[17] = "";
+
+    ds18b20_manager_get_device_address(0, rom_code_s);
+    esp_err_t ds_status = ds18b20_manager_read_temperature(0, &ds_centi);
+    uint32_t now = clock_ms();
+
+    sampling_scheduler_complete(SAMPLE_SOURCE_DS18B20, ds_status == ESP_OK, ds_centi, now);
+    if (ds_status != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to read DS18B20 sensor");
+        return;
+    }
+
+    TRACE(TRACE_EVENT_SAMPLE_VALUE, SAMPLE_SOURCE_DS18B20, ds_centi);
+    alarm_manager_feed(ALARM_SOURCE_DS18B20_TEMP, ds_centi, now);
+    sample_history_add(HISTORY_DS18B20_TEMP, ds_centi, now);
+
+    int32_t ds_values[] = { ds_centi };
+    int32_t ds_deadbands[] = { cfg->temp_deadband };
+    notify_listener(SAMPLE_SOURCE_DS18B20, ds_values, 1);
+
+    if (publish_filter_check(&ds_filter, ds_values, ds_deadbands, 1, cfg->heartbeat_cycles)) {
+        /* format_message returns an allocated string; use it and free it */
+        sensor_sample_t sample = {
+            .id = rom_code_s,
+            .sensor = "DS18B20",
+            .period_ms = sampling_scheduler_get_period(SAMPLE_SOURCE_DS18B20),
+            .fields = SENSOR_SAMPLE_TEMPERATURE,
+            .temperature = ds_centi,
+        };
+        char *json_msg = format_message(&sample);
+        if (json_msg) {
+            ESP_LOGD(TAG, "DS18B20 message: %s", json_msg);
+            mqtt_manager_publish("test/sensors/temperature", json_msg, cfg->publish_qos, cfg->publish_retain);
+            free(json_msg);
+        }
+    }
+}
+
+/**
+ * @brief Read DHT22, evaluate alarms and publish telemetry
+ */
+static void sample_dht22(const app_config_t *cfg)
+{
+    int32_t temp_centi = 0;
+    int32_t humidity_deci = 0;
+
+    esp_err_t dht_status = dht22_manager_read_data(&temp_centi, &humidity_deci);
+    uint32_t now = clock_ms();
+
+    sampling_scheduler_complete(SAMPLE_SOURCE_DHT22, dht_status == ESP_OK, temp_centi, now);
+    if (dht_status != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to read DHT22 sensor, skipping display update");
+        return;
+    }
+
+    alarm_manager_feed(ALARM_SOURCE_DHT22_TEMP, temp_centi, now);
+    alarm_manager_feed(ALARM_SOURCE_DHT22_HUMIDITY, humidity_deci, now);
+    sample_history_add(HISTORY_DHT22_TEMP, temp_centi, now);
+    sample_history_add(HISTORY_DHT22_HUMIDITY, humidity_deci, now);
+
+    TRACE(TRACE_EVENT_SAMPLE_VALUE, SAMPLE_SOURCE_DHT22, temp_centi);
+
+    int32_t dht_values[] = { temp_centi, humidity_deci };
+    int32_t dht_deadbands[] = { cfg->temp_deadband, cfg->humidity_deadband };
+    notify_listener(SAMPLE_SOURCE_DHT22, dht_values, 2);
+
+    if (publish_filter_check(&dht_filter, dht_values, dht_deadbands, 2, cfg->heartbeat_cycles)) {
+        /* format_message returns an allocated string; use it and free it */
+        sensor_sample_t sample = {
+            .id = "T01",
+            .sensor = "DHT22",
+            .period_ms = sampling_scheduler_get_period(SAMPLE_SOURCE_DHT22),
+            .fields = SENSOR_SAMPLE_TEMPERATURE | SENSOR_SAMPLE_HUMIDITY,
+            .temperature = temp_centi,
+            .humidity = humidity_deci,
+        };
+        char *json_msg = format_message(&sample);
+        if (json_msg) {
+            ESP_LOGD(TAG, "DHT22 message: %s", json_msg);
+            mqtt_manager_publish("test/sensors/temperature", json_msg, cfg->publish_qos, cfg->publish_retain);
+            free(json_msg);
+        }
+    }
+}
+
+/**
+ * @brief Temperature/humidity read function of an I2C sensor manager
+ */
+typedef esp_err_t (*climate_read_t)(int32_t *temperature, int32_t *humidity);
+
+/**
+ * @brief Alarm source and history series of an I2C temperature/humidity sensor
+ */
+typedef struct {
+    alarm_source_t alarm_temperature;
+    history_series_t history_temperature;
+    history_series_t history_humidity;
+} climate_sinks_t;
+
+static const climate_sinks_t sht3x_sinks = { ALARM_SOURCE_SHT3X_TEMP, HISTORY_SHT3X_TEMP, HISTORY_SHT3X_HUMIDITY };
+static const climate_sinks_t bme280_sinks = { ALARM_SOURCE_BME280_TEMP, HISTORY_BME280_TEMP, HISTORY_BME280_HUMIDITY };
+
+/**
+ * @brief Read an I2C temperature/humidity sensor (SHT3x, BME280), evaluate alarms and publish telemetry
+ */
+static void sample_i2c_climate(const app_config_t *cfg, sample_source_t source, const char *sensor,
+                               climate_read_t read, const climate_sinks_t *sinks, publish_filter_t *filter)
+{
+    int32_t temp_centi = 0;
+    int32_t humidity_deci = 0;
+
+    esp_err_t status = read(&temp_centi, &humidity_deci);
+    uint32_t now = clock_ms();
+
+    sampling_scheduler_complete(source, status == ESP_OK, temp_centi, now);
+    if (status != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to read %s sensor", sensor);
+        return;
+    }
+
+    alarm_manager_feed(sinks->alarm_temperature, temp_centi, now);
+    sample_history_add(sinks->history_temperature, temp_centi, now);
+    sample_history_add(sinks->history_humidity, humidity_deci, now);
+
+    TRACE(TRACE_EVENT_SAMPLE_VALUE, source, temp_centi);
+
+    int32_t values[] = { temp_centi, humidity_deci };
+    int32_t deadbands[] = { cfg->temp_deadband, cfg->humidity_deadband };
+    notify_listener(source, values, 2);
+
+    if (publish_filter_check(filter, values, deadbands, 2, cfg->heartbeat_cycles)) {
+        sensor_sample_t sample = {
+            .id = "T01",
+            .sensor = sensor,
+            .period_ms = sampling_scheduler_get_period(source),
+            .fields = SENSOR_SAMPLE_TEMPERATURE | SENSOR_SAMPLE_HUMIDITY,
+            .temperature = temp_centi,
+            .humidity = humidity_deci,
+        };
+        char *json_msg = format_message(&sample);
+        if (json_msg) {
+            ESP_LOGD(TAG, "%s message: %s", sensor, json_msg);
+            mqtt_manager_publish("test/sensors/temperature", json_msg, cfg->publish_qos, cfg->publish_retain);
+            free(json_msg);
+        }
+    }
+}
+
+/**
+ * @brief Read ADC voltage (with 1:1 voltage divider), evaluate alarms and publish telemetry
+ */
+static void sample_adc(const app_config_t *cfg)
+{
+    int voltage_mv = 0;
+
+    esp_err_t adc_status = adc_manager_read_voltage(&voltage_mv);
+    uint32_t now = clock_ms();
+
+    sampling_scheduler_complete(SAMPLE_SOURCE_ADC, adc_status == ESP_OK, voltage_mv, now);
+    if (adc_status != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to read ADC voltage");
+        return;
+    }
+
+    alarm_manager_feed(ALARM_SOURCE_VOLTAGE, voltage_mv, now);
+    sample_history_add(HISTORY_VOLTAGE, voltage_mv, now);
+    TRACE(TRACE_EVENT_SAMPLE_VALUE, SAMPLE_SOURCE_ADC, voltage_mv);
+
+    int32_t adc_values[] = { voltage_mv };
+    int32_t adc_deadbands[] = { cfg->voltage_deadband_mv };
+    notify_listener(SAMPLE_SOURCE_ADC, adc_values, 1);
+
+    if (publish_filter_check(&adc_filter, adc_values, adc_deadbands, 1, cfg->heartbeat_cycles)) {
+        /* format_message returns an allocated string; use it and free it */
+        sensor_sample_t sample = {
+            .id = "T01",
+            .sensor = "V",
+            .period_ms = sampling_scheduler_get_period(SAMPLE_SOURCE_ADC),
+            .fields = SENSOR_SAMPLE_VOLTAGE,
+            .voltage = voltage_mv,
+        };
+        char *json_msg = format_message(&sample);
+        if (json_msg) {
+            ESP_LOGD(TAG, "ADC message: %s", json_msg);
+            mqtt_manager_publish("test/sensors/voltage", json_msg, cfg->publish_qos, cfg->publish_retain);
+            free(json_msg);
+        }
+    }
+}
+
+void sample_pipeline_init(sample_clock_t clock, sample_listener_t listener)
+{
+    clock_ms = clock;
+    sample_listener = listener;
+    if (sensor_lock == NULL) {
+        sensor_lock = xSemaphoreCreateMutexStatic(&sensor_lock_buffer);
+    }
+}
+
+bool sample_pipeline_poll(const app_config_t *cfg, uint32_t *wait_ms)
+{
+    sampling_scheduler_configure(cfg->sample_period_ms, cfg->adaptive_sampling);
+
+    sample_source_t source = sampling_scheduler_next(clock_ms(), wait_ms);
+    if (source == SAMPLE_SOURCE_COUNT) {
+        return false;
+    }
+
+    xSemaphoreTake(sensor_lock, portMAX_DELAY);
+    TRACE(TRACE_EVENT_SAMPLE_START, source, 0);
+    switch (source) {
+        case SAMPLE_SOURCE_DS18B20:
+            sample_ds18b20(cfg);
+            break;
+        case SAMPLE_SOURCE_DHT22:
+            sample_dht22(cfg);
+            break;
+        case SAMPLE_SOURCE_ADC:
+            sample_adc(cfg);
+            break;
+        case SAMPLE_SOURCE_SHT3X:
+            sample_i2c_climate(cfg, source, "SHT3x", sht3x_manager_read_data, &sht3x_sinks, &sht3x_filter);
+            break;
+        case SAMPLE_SOURCE_BME280:
+            sample_i2c_climate(cfg, source, "BME280", bme280_manager_read_data, &bme280_sinks, &bme280_filter);
+            break;
+        default:
+            break;
+    }
+    TRACE(TRACE_EVENT_SAMPLE_END, source, 0);
+    xSemaphoreGive(sensor_lock);
+    return true;
+}
+
+esp_err_t sample_pipeline_lock(uint32_t timeout_ms)
+{
+    if (sensor_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return xSemaphoreTake(sensor_lock, pdMS_TO_TICKS(timeout_ms)) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+void sample_pipeline_unlock(void)
+{
+    xSemaphoreGive(sensor_lock);
+}
+
+uint32_t sample_pipeline_published(void)
+{
+    return ds_filter.published + dht_filter.published + adc_filter.published +
+           sht3x_filter.published + bme280_filter.published;
+}
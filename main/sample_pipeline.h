@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "config_manager.h"
+#include "sampling_scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Time source in ms, must continue across deep sleep
+ */
+typedef uint32_t (*sample_clock_t)(void);
+
+/**
+ * @brief Receives every valid sample, e.g. to update the display
+ *
+ * @param source Sensor that was sampled
+ * @param values Temperature in 0.01 °C and humidity in 0.1 %RH, or voltage in mV
+ * @param count  Number of values
+ */
+typedef void (*sample_listener_t)(sample_source_t source, const int32_t *values, size_t count);
+
+/**
+ * @brief Initialize the sample pipeline
+ *
+ * The pipeline reads the sensor managers, feeds the scheduler, alarms and
+ * history and publishes telemetry through the MQTT manager. It has no
+ * display or timer dependency so the host build can run it on a virtual clock.
+ *
+ * @param clock    Time source
+ * @param listener Called with every valid sample, may be NULL
+ */
+void sample_pipeline_init(sample_clock_t clock, sample_listener_t listener);
+
+/**
+ * @brief Sample the next due sensor
+ *
+ * Applies the sampling configuration, then reads, evaluates and publishes
+ * the sensor that is due.
+ *
+ * @param cfg     Current configuration
+ * @param wait_ms Set to the time until the next sensor is due when none is due now
+ * @return true if a sensor was sampled, false if none was due
+ */
+bool sample_pipeline_poll(const app_config_t *cfg, uint32_t *wait_ms);
+
+/**
+ * @brief Take exclusive access to the sensors
+ *
+ * Waits for a sample in progress to finish and holds off further samples
+ * until sample_pipeline_unlock(), so the sensor managers can be driven
+ * directly, e.g. by on-device benchmarks.
+ *
+ * @param timeout_ms Maximum wait for a sample in progress
+ * @return ESP_OK, ESP_ERR_TIMEOUT if the sample did not finish in time,
+ *         ESP_ERR_INVALID_STATE before sample_pipeline_init()
+ */
+esp_err_t sample_pipeline_lock(uint32_t timeout_ms);
+
+/**
+ * @brief Release sample_pipeline_lock()
+ */
+void sample_pipeline_unlock(void);
+
+/**
+ * @brief Number of telemetry messages published since cold boot
+ */
+uint32_t sample_pipeline_published(void);
+
+#ifdef __cplusplus
+}
+#endif
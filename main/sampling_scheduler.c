@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+#include "adaptive_rate.h"
+#include "sampling_scheduler.h"
+
+static const char *TAG = "sampling_scheduler";
+
+typedef struct {
+    bool enabled;
+    uint32_t last_ms;
+    uint32_t next_ms;
+    adaptive_rate_config_t policy;
+    adaptive_rate_t state;
+} sample_slot_t;
+
+// Fastest rate each sensor supports (DS18B20 conversion, DHT22 minimum interval)
+static const uint32_t min_period_ms[SAMPLE_SOURCE_COUNT] = {
+    [SAMPLE_SOURCE_DS18B20] = 1000,
+    [SAMPLE_SOURCE_DHT22] = 2000,
+    [SAMPLE_SOURCE_ADC] = 1000,
+    [SAMPLE_SOURCE_SHT3X] = 1000,
+    [SAMPLE_SOURCE_BME280] = 1000,
+};
+
+// Kept in RTC memory so schedule and adaptive state survive deep sleep
+static RTC_DATA_ATTR sample_slot_t slots[SAMPLE_SOURCE_COUNT];
+static RTC_DATA_ATTR uint32_t base_period = CONFIG_SAMPLE_PERIOD_MS;
+static RTC_DATA_ATTR bool adaptive_mode = false;
+
+/* signed distance between two wrapping millisecond timestamps */
+static int32_t time_diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+static void slot_configure(sample_source_t source)
+{
+    sample_slot_t *slot = &slots[source];
+    uint32_t min_period = min_period_ms[source];
+    uint32_t fast_period = CONFIG_ADAPTIVE_FAST_PERIOD_MS > min_period ? CONFIG_ADAPTIVE_FAST_PERIOD_MS : min_period;
+
+    slot->policy.max_period_ms = base_period > fast_period ? base_period : fast_period;
+    slot->policy.min_period_ms = fast_period;
+
+    if (source == SAMPLE_SOURCE_ADC) {
+        slot->policy.rate_threshold = CONFIG_ADAPTIVE_VOLTAGE_RATE;
+        slot->policy.stddev_threshold = CONFIG_ADAPTIVE_VOLTAGE_STDDEV;
+    } else {
+        // Kconfig values are in 0.1 °C, samples in 0.01 °C
+        slot->policy.rate_threshold = CONFIG_ADAPTIVE_TEMP_RATE * 10;
+        slot->policy.stddev_threshold = CONFIG_ADAPTIVE_TEMP_STDDEV;
+    }
+
+    if (slot->state.period_ms > slot->policy.max_period_ms || !adaptive_mode) {
+        slot->state.period_ms = slot->policy.max_period_ms;
+    }
+}
+
+void sampling_scheduler_init(uint32_t now_ms)
+{
+    for (int i = 0; i < SAMPLE_SOURCE_COUNT; i++) {
+        slot_configure((sample_source_t)i);
+        adaptive_rate_init(&slots[i].state, &slots[i].policy);
+        slots[i].enabled = true;
+        slots[i].last_ms = now_ms;
+        slots[i].next_ms = now_ms;
+    }
+}
+
+void sampling_scheduler_set_enabled(sample_source_t source, bool enabled)
+{
+    if (source < SAMPLE_SOURCE_COUNT) {
+        slots[source].enabled = enabled;
+    }
+}
+
+void sampling_scheduler_configure(uint32_t base_period_ms, bool adaptive)
+{
+    if (base_period_ms == base_period && adaptive == adaptive_mode) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Sampling period %" PRIu32 " ms, %s mode", base_period_ms, adaptive ? "adaptive" : "fixed");
+    base_period = base_period_ms;
+    adaptive_mode = adaptive;
+
+    for (int i = 0; i < SAMPLE_SOURCE_COUNT; i++) {
+        slot_configure((sample_source_t)i);
+        slots[i].next_ms = slots[i].last_ms + slots[i].state.period_ms;
+    }
+}
+
+sample_source_t sampling_scheduler_next(uint32_t now_ms, uint32_t *wait_ms)
+{
+    sample_source_t next = SAMPLE_SOURCE_COUNT;
+    int32_t best = INT32_MAX;
+
+    for (int i = 0; i < SAMPLE_SOURCE_COUNT; i++) {
+        if (!slots[i].enabled) {
+            continue;
+        }
+        int32_t remaining = time_diff(slots[i].next_ms, now_ms);
+        if (remaining < best) {
+            best = remaining;
+            next = (sample_source_t)i;
+        }
+    }
+
+    if (best > 0) {
+        if (wait_ms) {
+            *wait_ms = (uint32_t)best;
+        }
+        return SAMPLE_SOURCE_COUNT;
+    }
+
+    if (wait_ms) {
+        *wait_ms = 0;
+    }
+    return next;
+}
+
+void sampling_scheduler_complete(sample_source_t source, bool valid, int32_t value, uint32_t now_ms)
+{
+    if (source >= SAMPLE_SOURCE_COUNT) {
+        return;
+    }
+
+    sample_slot_t *slot = &slots[source];
+    uint32_t previous = slot->state.period_ms;
+
+    if (adaptive_mode && valid) {
+        adaptive_rate_update(&slot->state, &slot->policy, value, now_ms);
+        if (slot->state.period_ms != previous) {
+            ESP_LOGD(TAG, "Sensor %d period %" PRIu32 " -> %" PRIu32 " ms",
+                     source, previous, slot->state.period_ms);
+        }
+    }
+
+    slot->last_ms = now_ms;
+    slot->next_ms = now_ms + slot->state.period_ms;
+}
+
+uint32_t sampling_scheduler_get_period(sample_source_t source)
+{
+    if (source >= SAMPLE_SOURCE_COUNT) {
+        return 0;
+    }
+    return slots[source].state.period_ms;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sampled sensors
+ */
+typedef enum {
+    SAMPLE_SOURCE_DS18B20 = 0,
+    SAMPLE_SOURCE_DHT22,
+    SAMPLE_SOURCE_ADC,
+    SAMPLE_SOURCE_SHT3X,
+    SAMPLE_SOURCE_BME280,
+    SAMPLE_SOURCE_COUNT
+} sample_source_t;
+
+/**
+ * @brief Initialize the scheduler, all sensors are due immediately
+ *
+ * The scheduler state is kept in RTC memory. After a wake from deep sleep
+ * skip the init to continue the schedule, timestamps must then come from
+ * a time base that counts the sleep (sleep_manager_time_ms()).
+ *
+ * @param now_ms Current time in milliseconds
+ */
+void sampling_scheduler_init(uint32_t now_ms);
+
+/**
+ * @brief Set base period and sampling mode
+ *
+ * In fixed mode every sensor is sampled with base_period_ms. In adaptive
+ * mode base_period_ms is the floor rate each sensor decays back to while
+ * its signal is stable. Changing the period reschedules pending samples.
+ *
+ * @param base_period_ms Base sampling period
+ * @param adaptive       true to enable adaptive sampling
+ */
+void sampling_scheduler_configure(uint32_t base_period_ms, bool adaptive);
+
+/**
+ * @brief Enable or disable sampling of a sensor
+ *
+ * All sensors are enabled after init. A disabled sensor is never due,
+ * use this for optional sensors that were not detected.
+ *
+ * @param source  Sensor
+ * @param enabled false to stop scheduling the sensor
+ */
+void sampling_scheduler_set_enabled(sample_source_t source, bool enabled);
+
+/**
+ * @brief Get the sensor to sample next
+ *
+ * @param now_ms  Current time in milliseconds
+ * @param wait_ms Time until the next sensor is due, 0 if one is due now
+ * @return Sensor that is due now, SAMPLE_SOURCE_COUNT if none is due yet
+ */
+sample_source_t sampling_scheduler_next(uint32_t now_ms, uint32_t *wait_ms);
+
+/**
+ * @brief Report a finished sample and schedule the next one
+ *
+ * @param source Sampled sensor
+ * @param valid  true if the read succeeded and value is valid
+ * @param value  Sample value driving the adaptive policy
+ *               (0.01 °C for temperature sensors, mV for ADC)
+ * @param now_ms Time of the sample in milliseconds
+ */
+void sampling_scheduler_complete(sample_source_t source, bool valid, int32_t value, uint32_t now_ms);
+
+/**
+ * @brief Get current sampling period of a sensor
+ *
+ * @param source Sensor
+ * @return Period in milliseconds
+ */
+uint32_t sampling_scheduler_get_period(sample_source_t source);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "i2c_bus_manager.h"
+#include "messages/fixed_point.h"
+#include "sht3x_manager.h"
+
+static const char *TAG = "sht3x_manager";
+
+#define SHT3X_I2C_FREQ_HZ           400000
+#define SHT3X_TIMEOUT_MS            100
+#define SHT3X_MEASUREMENT_MS        16      // High repeatability, max 15.5 ms
+
+// Round up and add one tick, vTaskDelay() may return up to a tick early
+#define SHT3X_MEASUREMENT_TICKS     ((SHT3X_MEASUREMENT_MS + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS + 1)
+
+static const uint16_t sht3x_addresses[] = { 0x44, 0x45 };
+
+// Single shot, high repeatability, clock stretching disabled
+static const uint8_t cmd_measure[] = { 0x24, 0x00 };
+
+static i2c_master_dev_handle_t dev = NULL;
+
+/**
+ * @brief CRC-8 of a data word (polynomial 0x31, init 0xFF)
+ */
+static uint8_t sht3x_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+esp_err_t sht3x_manager_init(void)
+{
+    for (size_t i = 0; i < sizeof(sht3x_addresses) / sizeof(sht3x_addresses[0]); i++) {
+        if (i2c_bus_manager_add_device(sht3x_addresses[i], SHT3X_I2C_FREQ_HZ, &dev) == ESP_OK) {
+            ESP_LOGI(TAG, "SHT3x found at address 0x%02X", sht3x_addresses[i]);
+            return ESP_OK;
+        }
+    }
+
+    dev = NULL;
+    ESP_LOGI(TAG, "No SHT3x sensor found");
+    return ESP_ERR_NOT_FOUND;
+}
+
+bool sht3x_manager_is_present(void)
+{
+    return dev != NULL;
+}
+
+esp_err_t sht3x_manager_read_data(int32_t *temperature, int32_t *humidity)
+{
+    if (temperature == NULL && humidity == NULL) {
+        ESP_LOGE(TAG, "Both temperature and humidity pointers are NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t status = i2c_bus_manager_transfer(dev, cmd_measure, sizeof(cmd_measure), NULL, 0, SHT3X_TIMEOUT_MS);
+    if (status != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start measurement: %s", esp_err_to_name(status));
+        return status;
+    }
+
+    vTaskDelay(SHT3X_MEASUREMENT_TICKS);
+
+    // Temperature word + CRC, humidity word + CRC
+    uint8_t data[6];
+    status = i2c_bus_manager_transfer(dev, NULL, 0, data, sizeof(data), SHT3X_TIMEOUT_MS);
+    if (status != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read measurement: %s", esp_err_to_name(status));
+        return status;
+    }
+
+    if (sht3x_crc8(&data[0], 2) != data[2] || sht3x_crc8(&data[3], 2) != data[5]) {
+        ESP_LOGE(TAG, "CRC mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    uint32_t raw_temperature = (uint32_t)data[0] << 8 | data[1];
+    uint32_t raw_humidity = (uint32_t)data[3] << 8 | data[4];
+
+    // T = -45 + 175 * raw / 65535 °C, RH = 100 * raw / 65535 %
+    int32_t centi = -4500 + (int32_t)((17500 * raw_temperature + 32767) / 65535);
+    int32_t permille = (int32_t)((1000 * raw_humidity + 32767) / 65535);
+
+    if (temperature) {
+        *temperature = centi;
+    }
+    if (humidity) {
+        *humidity = permille;
+    }
+
+    char temperature_str[12];
+    char humidity_str[12];
+    format_fixed(temperature_str, sizeof(temperature_str), centi, 2);
+    format_fixed(humidity_str, sizeof(humidity_str), permille, 1);
+    ESP_LOGD(TAG, "Temperature: %s°C, Humidity: %s%%", temperature_str, humidity_str);
+
+    return ESP_OK;
+}
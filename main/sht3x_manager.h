@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Detect an SHT3x sensor on the shared I2C bus
+ *
+ * Tries addresses 0x44 and 0x45. The I2C bus manager must be initialized.
+ *
+ * @return ESP_OK if a sensor was found, ESP_ERR_NOT_FOUND otherwise
+ */
+esp_err_t sht3x_manager_init(void);
+
+/**
+ * @brief Check if an SHT3x sensor was found
+ *
+ * @return true if sht3x_manager_init() found a sensor
+ */
+bool sht3x_manager_is_present(void);
+
+/**
+ * @brief Read temperature and humidity (single shot, high repeatability)
+ *
+ * Takes about 16 ms. Integer conversion only.
+ *
+ * @param temperature Pointer to store the temperature value in 0.01 °C
+ * @param humidity Pointer to store the humidity value in 0.1 %RH (per-mille)
+ * @return ESP_OK on success, ESP_ERR_INVALID_CRC on corrupted data, error code otherwise
+ */
+esp_err_t sht3x_manager_read_data(int32_t *temperature, int32_t *humidity);
+
+#ifdef __cplusplus
+}
+#endif
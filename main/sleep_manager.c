@@ -0,0 +1,89 @@
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "log_manager.h"
+#include "sleep_manager.h"
+
+static const char *TAG = "sleep_manager";
+
+#define SLEEP_STATE_MAGIC 0x534C5031u  // "SLP1"
+
+/**
+ * @brief State retained in RTC memory across deep sleep
+ */
+typedef struct {
+    uint32_t magic;             // SLEEP_STATE_MAGIC once initialized
+    uint32_t time_base_ms;      // sleep_manager_time_ms() at the start of this wake
+    uint32_t wake_count;
+    uint32_t last_awake_ms;
+    uint64_t total_awake_ms;    // Summed over all completed cycles
+    uint64_t total_sleep_ms;
+} sleep_state_t;
+
+static RTC_DATA_ATTR sleep_state_t state;
+static bool woke_from_sleep = false;
+
+/**
+ * @brief Estimate the average current in µA over all completed cycles
+ */
+static uint32_t average_current_ua(void)
+{
+    uint64_t total_ms = state.total_awake_ms + state.total_sleep_ms;
+    if (total_ms == 0) {
+        return 0;
+    }
+
+    uint64_t charge = state.total_awake_ms * CONFIG_DUTY_CYCLE_ACTIVE_CURRENT_MA * 1000 +
+                      state.total_sleep_ms * CONFIG_DUTY_CYCLE_SLEEP_CURRENT_UA;
+    return (uint32_t)(charge / total_ms);
+}
+
+void sleep_manager_init(void)
+{
+    woke_from_sleep = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER && state.magic == SLEEP_STATE_MAGIC;
+
+    if (!woke_from_sleep) {
+        state = (sleep_state_t) { .magic = SLEEP_STATE_MAGIC };
+        return;
+    }
+
+    state.wake_count++;
+    ESP_LOGI(TAG, "Wake %" PRIu32 " from deep sleep, last cycle awake %" PRIu32 " ms, average current ~%" PRIu32 " uA",
+             state.wake_count, state.last_awake_ms, average_current_ua());
+}
+
+bool sleep_manager_is_wake(void)
+{
+    return woke_from_sleep;
+}
+
+uint32_t sleep_manager_time_ms(void)
+{
+    return state.time_base_ms + (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void sleep_manager_get_stats(sleep_stats_t *stats)
+{
+    stats->wake_count = state.wake_count;
+    stats->last_awake_ms = state.last_awake_ms;
+    stats->avg_current_ua = average_current_ua();
+}
+
+void sleep_manager_enter(uint32_t sleep_ms)
+{
+    // Boot time before app_main is not counted, esp_timer starts with the app
+    uint32_t awake_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    state.last_awake_ms = awake_ms;
+    state.total_awake_ms += awake_ms;
+    state.total_sleep_ms += sleep_ms;
+    state.time_base_ms += awake_ms + sleep_ms;
+
+    ESP_LOGI(TAG, "Awake for %" PRIu32 " ms, sleeping for %" PRIu32 " ms", awake_ms, sleep_ms);
+    log_manager_flush(100);
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000);
+    esp_deep_sleep_start();
+}
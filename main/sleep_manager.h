@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Duty-cycle statistics, kept in RTC memory across deep sleep
+ */
+typedef struct {
+    uint32_t wake_count;        // Wakes from deep sleep since cold boot
+    uint32_t last_awake_ms;     // Wake-to-sleep time of the previous cycle
+    uint32_t avg_current_ua;    // Estimated average current since cold boot
+} sleep_stats_t;
+
+/**
+ * @brief Initialize the sleep manager, call first thing in app_main
+ *
+ * Detects a timer wake from deep sleep and keeps the RTC-retained state,
+ * any other reset starts over from zero.
+ */
+void sleep_manager_init(void);
+
+/**
+ * @brief Check if this boot is a wake from deep sleep with valid retained state
+ *
+ * @return true after a timer wake, false after a cold boot or reset
+ */
+bool sleep_manager_is_wake(void);
+
+/**
+ * @brief Get milliseconds since cold boot, counting the time spent in deep sleep
+ *
+ * Equals the uptime until the first deep sleep. Use this as the time base
+ * of everything that is retained across deep sleep.
+ *
+ * @return Time in milliseconds
+ */
+uint32_t sleep_manager_time_ms(void);
+
+/**
+ * @brief Get the duty-cycle statistics
+ *
+ * The average current is estimated from the awake and sleep times with
+ * CONFIG_DUTY_CYCLE_ACTIVE_CURRENT_MA and CONFIG_DUTY_CYCLE_SLEEP_CURRENT_UA,
+ * there is no current measurement.
+ *
+ * @param stats Destination of the statistics
+ */
+void sleep_manager_get_stats(sleep_stats_t *stats);
+
+/**
+ * @brief Enter deep sleep, the device reboots after sleep_ms
+ *
+ * Records the awake time of this cycle before sleeping. Does not return.
+ *
+ * @param sleep_ms Sleep time in milliseconds
+ */
+void sleep_manager_enter(uint32_t sleep_ms) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
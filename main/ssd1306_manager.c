@@ -1,186 +1,399 @@
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "esp_system.h"
-#include "driver/i2c.h"
-#include "driver/gpio.h"
-#include "ssd1306.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "i2c_bus_manager.h"
 #include "ssd1306_manager.h"
+#include "display_framebuffer.h"
+#include "trend_plot.h"
+#include "messages/fixed_point.h"
 #include "esp_wifi.h"
 #include "esp_netif.h"
 
 static const char *TAG = "ssd1306_manager";
 
-#define I2C_MASTER_SCL_IO           9       /*!< GPIO number for I2C master clock */
-#define I2C_MASTER_SDA_IO           8       /*!< GPIO number for I2C master data  */
-#define I2C_MASTER_NUM              I2C_NUM_0   /*!< I2C port number for master dev */
 #define I2C_MASTER_FREQ_HZ          400000  /*!< I2C master clock frequency */
-#define I2C_MASTER_TX_BUF_DISABLE   0       /*!< I2C master doesn't need buffer */
-#define I2C_MASTER_RX_BUF_DISABLE   0       /*!< I2C master doesn't need buffer */
 #define I2C_MASTER_TIMEOUT_MS       1000
-#define ACK_CHECK_EN                0x1     /*!< I2C master will check ack from slave*/
-#define ACK_VAL                     0x0     /*!< I2C ack value */
-#define NACK_VAL                    0x1     /*!< I2C nack value */
 
-static ssd1306_handle_t ssd1306_dev = NULL;
+#define SSD1306_I2C_ADDRESS         0x3C
+#define SSD1306_CONTROL_CMD         0x00    /*!< Control byte: command stream */
+#define SSD1306_CONTROL_CMD_SINGLE  0x80    /*!< Control byte: one command byte follows */
+#define SSD1306_CONTROL_DATA        0x40    /*!< Control byte: GRAM data stream */
+#define SSD1306_CMD_SET_COLUMN_ADDR 0x21
+#define SSD1306_CMD_SET_PAGE_ADDR   0x22
+#define SSD1306_SPAN_HEADER_SIZE    13      /*!< 6 window commands with control bytes + data control byte */
+#define SSD1306_FULL_FRAME_BYTES    (DISPLAY_FB_PAGES * (DISPLAY_FB_WIDTH + SSD1306_SPAN_HEADER_SIZE))
+
+#define DISPLAY_TASK_STACK_SIZE     4096
+#define DISPLAY_TASK_PRIORITY       4
+#define DISPLAY_FRAME_INTERVAL_MS   (1000 / CONFIG_DISPLAY_MAX_FPS)
+
+// Display task notification bits, several requests coalesce into one frame
+#define DISPLAY_NOTIFY_DATA         BIT0    /*!< Cached sensor values changed */
+#define DISPLAY_NOTIFY_SCREEN       BIT1    /*!< Active screen changed */
+#define DISPLAY_NOTIFY_CLEAR        BIT2    /*!< Blank the panel until the next update */
+#define DISPLAY_NOTIFY_WAKE         BIT3    /*!< User activity, restarts the inactivity timer */
+#define DISPLAY_NOTIFY_FULL         BIT4    /*!< Send the full frame now and report when it is out */
+
+#define DISPLAY_SLEEP_TICKS         pdMS_TO_TICKS(CONFIG_DISPLAY_SLEEP_TIMEOUT_S * 1000)
+
+// Panel power-up sequence: 128x64, charge pump on, horizontal addressing,
+// column 127 on SEG0 and COM scan from COM63 so (0,0) is the top left pixel
+static const uint8_t ssd1306_init_cmds[] = {
+    SSD1306_CONTROL_CMD,
+    0xAE,           // Display off
+    0xD5, 0x80,     // Clock divide ratio / oscillator frequency
+    0xA8, 0x3F,     // Multiplex ratio 64
+    0xD3, 0x00,     // Display offset 0
+    0x40,           // Start line 0
+    0x8D, 0x14,     // Charge pump on
+    0x20, 0x00,     // Horizontal addressing mode
+    0xA1,           // Segment remap
+    0xC8,           // COM scan direction remapped
+    0xDA, 0x12,     // COM pins alternative configuration
+    0x81, 0xCF,     // Contrast
+    0xD9, 0xF1,     // Pre-charge period
+    0xDB, 0x40,     // VCOMH deselect level
+    0xA4,           // Display follows GRAM
+    0xA6,           // Normal (not inverted)
+    0xAF,           // Display on
+};
+
+static const uint8_t ssd1306_display_off_cmd[] = { SSD1306_CONTROL_CMD, 0xAE };
+static const uint8_t ssd1306_display_on_cmd[] = { SSD1306_CONTROL_CMD, 0xAF };
+
+static i2c_master_dev_handle_t ssd1306_dev = NULL;
+static TaskHandle_t display_task_handle = NULL;
+static volatile bool display_asleep = false;    // Panel switched off after inactivity
 static bool initialized = false;
 static screen_id_t current_screen = SCREEN_TEMPERATURES;
+static history_series_t trend_series = HISTORY_DS18B20_TEMP;   // Sensor shown on SCREEN_TREND
+static display_refresh_stats_t refresh_stats;
+static uint32_t frame_bytes;
+
+// Transfers are asynchronous, spans are staged here until the bus has sent them
+static uint8_t span_buffers[DISPLAY_FB_PAGES][SSD1306_SPAN_HEADER_SIZE + DISPLAY_FB_WIDTH];
+static volatile bool transfer_failed = false;
+
+// Sequence number of the latest DISPLAY_NOTIFY_FULL request. The display task
+// reports the number it read before drawing once that frame is transferred,
+// so a completion of an earlier request that timed out is told apart.
+static volatile uint32_t full_frame_requested = 0;
+static QueueHandle_t full_frame_done = NULL;
+static StaticQueue_t full_frame_done_buffer;
+static uint8_t full_frame_done_storage[sizeof(uint32_t)];
+
+// Cache for sensor data, written by the sampling task, read by the display task
+typedef struct {
+    int32_t ds_temp;        // 0.01 °C
+    int32_t dht_temp;       // 0.01 °C
+    int32_t dht_humidity;   // 0.1 %RH
+    int voltage;            // mV
+} display_values_t;
+
+static display_values_t cached_values;
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
 
-// Cache for sensor data
-static float cached_ds_temp = 0.0f;
-static float cached_dht_temp = 0.0f;
-static float cached_dht_humidity = 0.0f;
-static int cached_voltage = 0.0f;
+static void display_task(void *arg);
+
+// Static screen text, rendered once at init and blitted on every frame
+#define LABEL_TABLE(X) \
+    X(LABEL_TITLE_SENSORS,     "== SENSORS ==") \
+    X(LABEL_TITLE_POWER,       "== POWER ==") \
+    X(LABEL_TITLE_MEMORY,      "== MEMORY ==") \
+    X(LABEL_TITLE_NETWORK,     "== NETWORK ==") \
+    X(LABEL_DS18B20,           "DS18B20: ") \
+    X(LABEL_DHT22_TEMP,        "T DHT22: ") \
+    X(LABEL_DHT22_HUMIDITY,    "H DHT22: ") \
+    X(LABEL_VOLTAGE,           "Voltage: ") \
+    X(LABEL_HEAP,              "Heap: ") \
+    X(LABEL_MIN_HEAP,          "Min: ") \
+    X(LABEL_UPTIME,            "Up: ") \
+    X(LABEL_WIFI_CONNECTED,    "WiFi: Connected") \
+    X(LABEL_WIFI_DISCONNECTED, "WiFi: Disconnected") \
+    X(LABEL_CONNECTING,        "Connecting...") \
+    X(LABEL_SSID,              "SSID: ") \
+    X(LABEL_RSSI,              "RSSI: ") \
+    X(LABEL_IP,                "IP: ") \
+    X(LABEL_UNIT_CELSIUS,      " *C") \
+    X(LABEL_UNIT_PERCENT,      " %") \
+    X(LABEL_UNIT_VOLT,         " V") \
+    X(LABEL_UNIT_KB,           " kB") \
+    X(LABEL_UNIT_DBM,          " dBm")
+
+#define LABEL_ID(id, text) id,
+typedef enum {
+    LABEL_TABLE(LABEL_ID)
+    LABEL_COUNT
+} label_id_t;
+#undef LABEL_ID
+
+#define LABEL_TEXT(id, text) [id] = text,
+static const char *const label_texts[LABEL_COUNT] = {
+    LABEL_TABLE(LABEL_TEXT)
+};
+#undef LABEL_TEXT
+
+// Every label must fit the pool, a missing unit is otherwise only noticed on the panel
+#define LABEL_WIDTH(id, text) + (sizeof(text) - 1) * DISPLAY_FB_GLYPH_WIDTH
+_Static_assert(0 LABEL_TABLE(LABEL_WIDTH) <= DISPLAY_FB_LABEL_POOL_COLUMNS,
+               "DISPLAY_FB_LABEL_POOL_COLUMNS is too small for the screen labels");
+#undef LABEL_WIDTH
+
+static display_fb_label_t labels[LABEL_COUNT];
+
+/**
+ * @brief Transfer completion callback, runs in ISR context
+ */
+static bool IRAM_ATTR on_transfer_done(i2c_master_dev_handle_t dev, const i2c_master_event_data_t *evt, void *arg)
+{
+    if (evt->event != I2C_EVENT_DONE) {
+        transfer_failed = true;
+    }
+    return false;
+}
+
+/**
+ * @brief Queue one run of GRAM bytes, called by display_fb_flush()
+ *
+ * Window commands and data go out in a single transaction: each command
+ * byte is prefixed by a single-command control byte, the final data
+ * control byte switches the panel to GRAM writes. Returns as soon as the
+ * transfer is queued.
+ */
+static esp_err_t write_gram(uint8_t page, uint8_t column, const uint8_t *data, size_t len, void *ctx)
+{
+    uint8_t *buf = span_buffers[page];
+    const uint8_t header[SSD1306_SPAN_HEADER_SIZE] = {
+        SSD1306_CONTROL_CMD_SINGLE, SSD1306_CMD_SET_COLUMN_ADDR,
+        SSD1306_CONTROL_CMD_SINGLE, column,
+        SSD1306_CONTROL_CMD_SINGLE, (uint8_t)(column + len - 1),
+        SSD1306_CONTROL_CMD_SINGLE, SSD1306_CMD_SET_PAGE_ADDR,
+        SSD1306_CONTROL_CMD_SINGLE, page,
+        SSD1306_CONTROL_CMD_SINGLE, page,
+        SSD1306_CONTROL_DATA,
+    };
+
+    memcpy(buf, header, sizeof(header));
+    memcpy(&buf[sizeof(header)], data, len);
+    frame_bytes += sizeof(header) + len;
+    return i2c_master_transmit(ssd1306_dev, buf, sizeof(header) + len, I2C_MASTER_TIMEOUT_MS);
+}
+
+/**
+ * @brief Queue changed parts of the framebuffer and update the traffic counters
+ *
+ * Waits for the previous frame to leave the staging buffers (the task is
+ * blocked, not spinning, meanwhile) but not for the new one, so its
+ * transfer overlaps with rendering the next frame.
+ */
+static esp_err_t flush_framebuffer(void)
+{
+    esp_err_t ret = i2c_master_bus_wait_all_done(i2c_bus_manager_get_bus(), I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK || transfer_failed) {
+        // Panel content is unknown, resend the full frame
+        ESP_LOGW(TAG, "Display transfer failed, resending full frame");
+        transfer_failed = false;
+        display_fb_invalidate();
+    }
+
+    frame_bytes = 0;
+    ret = display_fb_flush(write_gram, NULL);
+
+    refresh_stats.refreshes++;
+    refresh_stats.last_bytes = frame_bytes;
+    refresh_stats.total_bytes += frame_bytes;
+    ESP_LOGD(TAG, "Refresh sent %" PRIu32 " bytes (full frame %d)", frame_bytes, SSD1306_FULL_FRAME_BYTES);
+
+    return ret;
+}
 
 esp_err_t ssd1306_manager_init(void)
 {
     ESP_LOGI(TAG, "Initializing SSD1306 OLED display");
-    ESP_LOGI(TAG, "I2C pins: SDA=GPIO%d, SCL=GPIO%d", I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
-    
-    // Configure I2C
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
-        .clk_flags = 0,
-    };
-    
-    esp_err_t ret = i2c_param_config(I2C_MASTER_NUM, &conf);
+
+    // The display shares the bus with the I2C sensors
+    esp_err_t ret = i2c_bus_manager_init();
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2C config failed: %s", esp_err_to_name(ret));
         ESP_LOGW(TAG, "Continuing without display...");
         return ret;
     }
     
-    ret = i2c_driver_install(I2C_MASTER_NUM, conf.mode, 
-                            I2C_MASTER_RX_BUF_DISABLE, 
-                            I2C_MASTER_TX_BUF_DISABLE, 0);
+    // Longer delay for I2C to stabilize
+    vTaskDelay(pdMS_TO_TICKS(500));
+
+    ret = i2c_bus_manager_add_device(SSD1306_I2C_ADDRESS, I2C_MASTER_FREQ_HZ, &ssd1306_dev);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2C driver install failed: %s", esp_err_to_name(ret));
-        ESP_LOGW(TAG, "Continuing without display...");
+        ESP_LOGW(TAG, "No response from address 0x%02X", SSD1306_I2C_ADDRESS);
+        return ret;
+    }
+    ESP_LOGI(TAG, "SSD1306 found at address 0x%02X!", SSD1306_I2C_ADDRESS);
+
+    // Transfers are queued without waiting, failures are reported to this callback
+    const i2c_master_event_callbacks_t callbacks = {
+        .on_trans_done = on_transfer_done,
+    };
+    ret = i2c_master_register_event_callbacks(ssd1306_dev, &callbacks, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register I2C callbacks: %s", esp_err_to_name(ret));
         return ret;
     }
-    
-    ESP_LOGI(TAG, "I2C driver installed successfully");
-    
-    // Longer delay for I2C to stabilize
-    vTaskDelay(pdMS_TO_TICKS(500));
 
-    ssd1306_dev = ssd1306_create(I2C_MASTER_NUM, 0x3C);
-    if (ssd1306_dev == NULL) {
-        ESP_LOGW(TAG, "Failed to create device handle for address 0x%02X", 0x3C);
+    ret = i2c_master_transmit(ssd1306_dev, ssd1306_init_cmds, sizeof(ssd1306_init_cmds), I2C_MASTER_TIMEOUT_MS);
+    if (ret == ESP_OK) {
+        ret = i2c_master_bus_wait_all_done(i2c_bus_manager_get_bus(), I2C_MASTER_TIMEOUT_MS);
+    }
+    if (ret != ESP_OK || transfer_failed) {
+        ESP_LOGW(TAG, "Failed to initialize panel: %s", esp_err_to_name(ret));
+        return ret != ESP_OK ? ret : ESP_FAIL;
     }
     
-    ret = ssd1306_init(ssd1306_dev);
-    if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "SSD1306 found at address 0x%02X!", 0x3C);
-    } else {
-        ESP_LOGW(TAG, "No response from address 0x%02X", 0x3C);
-        ssd1306_delete(ssd1306_dev);
-        ssd1306_dev = NULL;
+    display_fb_init();
+    for (int i = 0; i < LABEL_COUNT; i++) {
+        ret = display_fb_label_render(&labels[i], label_texts[i]);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Label pool exhausted at label %d", i);
+            return ret;
+        }
     }
     
     // Clear the screen
-    ssd1306_clear_screen(ssd1306_dev, 0x00);
-    ssd1306_refresh_gram(ssd1306_dev);
+    display_fb_clear();
+    display_fb_invalidate();
+    flush_framebuffer();
+    
+    full_frame_done = xQueueCreateStatic(1, sizeof(uint32_t), full_frame_done_storage, &full_frame_done_buffer);
+    BaseType_t task_created = xTaskCreate(display_task, "display_task", DISPLAY_TASK_STACK_SIZE,
+                                          NULL, DISPLAY_TASK_PRIORITY, &display_task_handle);
+    if (task_created != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create display task");
+        return ESP_FAIL;
+    }
     
     initialized = true;
-    ESP_LOGI(TAG, "SSD1306 initialized successfully at 0x%02X (SDA=%d, SCL=%d)",
-             0x3C, I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
+    ESP_LOGI(TAG, "SSD1306 initialized successfully at 0x%02X", SSD1306_I2C_ADDRESS);
     
     return ESP_OK;
 }
 
-void set_temp_values(float ds_temp, float dht_temp, float dht_humidity)
+void set_temp_values(int32_t ds_temp, int32_t dht_temp, int32_t dht_humidity)
 {
-    cached_ds_temp = ds_temp;
-    cached_dht_temp = dht_temp;
-    cached_dht_humidity = dht_humidity;
+    taskENTER_CRITICAL(&cache_lock);
+    cached_values.ds_temp = ds_temp;
+    cached_values.dht_temp = dht_temp;
+    cached_values.dht_humidity = dht_humidity;
+    taskEXIT_CRITICAL(&cache_lock);
 }
 
 void set_voltage_value(int voltage)
 {
-    cached_voltage = voltage;
+    taskENTER_CRITICAL(&cache_lock);
+    cached_values.voltage = voltage;
+    taskEXIT_CRITICAL(&cache_lock);
 }
 
-esp_err_t ssd1306_manager_clear(void)
+/**
+ * @brief Ask the display task for a new frame, never blocks
+ */
+static esp_err_t request_frame(uint32_t bits)
 {
-    if (!initialized || ssd1306_dev == NULL) {
+    if (!initialized || display_task_handle == NULL) {
         return ESP_ERR_INVALID_STATE;
     }
-    
-    ssd1306_clear_screen(ssd1306_dev, 0x00);
-    return ssd1306_refresh_gram(ssd1306_dev);
+
+    xTaskNotify(display_task_handle, bits, eSetBits);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_manager_clear(void)
+{
+    return request_frame(DISPLAY_NOTIFY_CLEAR);
+}
+
+void ssd1306_manager_get_refresh_stats(display_refresh_stats_t *out)
+{
+    *out = refresh_stats;
 }
 
 // ============= Multi-Screen Functions =============
 
-static void draw_screen_temperatures(void)
+static void draw_screen_temperatures(const display_values_t *values)
 {
-    char line[32];
+    uint8_t x;
     
     // Title
-    ssd1306_draw_string(ssd1306_dev, 0, 0, (uint8_t *)"== SENSORS ==", 12, 1);
+    display_fb_draw_label(0, 0, &labels[LABEL_TITLE_SENSORS]);
     
     // DS18B20
-    snprintf(line, sizeof(line), "DS18B20: %.1f *C", cached_ds_temp);
-    ssd1306_draw_string(ssd1306_dev, 0, 16, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 16, &labels[LABEL_DS18B20]);
+    x = display_fb_draw_fixed(x, 16, fixed_rescale(values->ds_temp, 2, 1), 1);
+    display_fb_draw_label(x, 16, &labels[LABEL_UNIT_CELSIUS]);
     
     // DHT22 Temp
-    snprintf(line, sizeof(line), "T DHT22: %.1f *C", cached_dht_temp);
-    ssd1306_draw_string(ssd1306_dev, 0, 28, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 28, &labels[LABEL_DHT22_TEMP]);
+    x = display_fb_draw_fixed(x, 28, fixed_rescale(values->dht_temp, 2, 1), 1);
+    display_fb_draw_label(x, 28, &labels[LABEL_UNIT_CELSIUS]);
     
     // DHT22 Humidity
-    snprintf(line, sizeof(line), "H DHT22: %.1f %%", cached_dht_humidity);
-    ssd1306_draw_string(ssd1306_dev, 0, 40, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 40, &labels[LABEL_DHT22_HUMIDITY]);
+    x = display_fb_draw_fixed(x, 40, values->dht_humidity, 1);
+    display_fb_draw_label(x, 40, &labels[LABEL_UNIT_PERCENT]);
 }
 
-static void draw_screen_adc(void)
+static void draw_screen_adc(const display_values_t *values)
 {
-    char line[32];
+    uint8_t x;
     
     // Title
-    ssd1306_draw_string(ssd1306_dev, 0, 0, (uint8_t *)"== POWER ==", 12, 1);
+    display_fb_draw_label(0, 0, &labels[LABEL_TITLE_POWER]);
     
     // Voltage in V
-    snprintf(line, sizeof(line), "Voltage: %.2f V", cached_voltage / 1000.0f);
-    ssd1306_draw_string(ssd1306_dev, 0, 16, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 16, &labels[LABEL_VOLTAGE]);
+    x = display_fb_draw_fixed(x, 16, fixed_rescale(values->voltage, 3, 2), 2);
+    display_fb_draw_label(x, 16, &labels[LABEL_UNIT_VOLT]);
 }
 
 static void draw_screen_system(void)
 {
-    char line[32];
+    uint8_t x;
     
     // Title
-    ssd1306_draw_string(ssd1306_dev, 0, 0, (uint8_t *)"== MEMORY ==", 12, 1);
+    display_fb_draw_label(0, 0, &labels[LABEL_TITLE_MEMORY]);
     
     // Free heap
     uint32_t free_heap = esp_get_free_heap_size();
-    snprintf(line, sizeof(line), "Heap: %lu kB", free_heap / 1024);
-    ssd1306_draw_string(ssd1306_dev, 0, 16, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 16, &labels[LABEL_HEAP]);
+    x = display_fb_draw_fixed(x, 16, (int32_t)(free_heap / 1024), 0);
+    display_fb_draw_label(x, 16, &labels[LABEL_UNIT_KB]);
     
     // Minimum free heap
     uint32_t min_heap = esp_get_minimum_free_heap_size();
-    snprintf(line, sizeof(line), "Min: %lu kB", min_heap / 1024);
-    ssd1306_draw_string(ssd1306_dev, 0, 28, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 28, &labels[LABEL_MIN_HEAP]);
+    x = display_fb_draw_fixed(x, 28, (int32_t)(min_heap / 1024), 0);
+    display_fb_draw_label(x, 28, &labels[LABEL_UNIT_KB]);
     
     // Uptime
     uint32_t uptime_sec = esp_log_timestamp() / 1000;
     uint32_t hours = uptime_sec / 3600;
     uint32_t minutes = (uptime_sec % 3600) / 60;
-    snprintf(line, sizeof(line), "Up: %luh %lum", hours, minutes);
-    ssd1306_draw_string(ssd1306_dev, 0, 40, (uint8_t *)line, 12, 1);
+    x = display_fb_draw_label(0, 40, &labels[LABEL_UPTIME]);
+    x = display_fb_draw_fixed(x, 40, (int32_t)hours, 0);
+    x = display_fb_draw_string(x, 40, "h ");
+    x = display_fb_draw_fixed(x, 40, (int32_t)minutes, 0);
+    display_fb_draw_string(x, 40, "m");
 }
 
 static void draw_screen_network(void)
 {
-    char line[32];
+    uint8_t x;
     
     // Title
-    ssd1306_draw_string(ssd1306_dev, 0, 0, (uint8_t *)"== NETWORK ==", 12, 1);
+    display_fb_draw_label(0, 0, &labels[LABEL_TITLE_NETWORK]);
     
     // WiFi status
     wifi_ap_record_t ap_info;
@@ -188,36 +401,39 @@ static void draw_screen_network(void)
     
     if (ret == ESP_OK) {
         // Connected
-        snprintf(line, sizeof(line), "WiFi: Connected");
-        ssd1306_draw_string(ssd1306_dev, 0, 16, (uint8_t *)line, 12, 1);
+        display_fb_draw_label(0, 16, &labels[LABEL_WIFI_CONNECTED]);
         
         // SSID (truncate if too long)
         char ssid[17];
         strncpy(ssid, (char *)ap_info.ssid, 16);
         ssid[16] = '\0';
-        snprintf(line, sizeof(line), "SSID: %s", ssid);
-        ssd1306_draw_string(ssd1306_dev, 0, 28, (uint8_t *)line, 12, 1);
+        x = display_fb_draw_label(0, 28, &labels[LABEL_SSID]);
+        display_fb_draw_string(x, 28, ssid);
         
         // RSSI
-        snprintf(line, sizeof(line), "RSSI: %d dBm", ap_info.rssi);
-        ssd1306_draw_string(ssd1306_dev, 0, 40, (uint8_t *)line, 12, 1);
+        x = display_fb_draw_label(0, 40, &labels[LABEL_RSSI]);
+        x = display_fb_draw_fixed(x, 40, ap_info.rssi, 0);
+        display_fb_draw_label(x, 40, &labels[LABEL_UNIT_DBM]);
         
         // IP address
         esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
         if (netif) {
             esp_netif_ip_info_t ip_info;
             if (esp_netif_get_ip_info(netif, &ip_info) == ESP_OK) {
-                snprintf(line, sizeof(line), "IP: " IPSTR, IP2STR(&ip_info.ip));
-                ssd1306_draw_string(ssd1306_dev, 0, 52, (uint8_t *)line, 12, 1);
+                x = display_fb_draw_label(0, 52, &labels[LABEL_IP]);
+                for (int i = 0; i < 4; i++) {
+                    // esp_ip4_addr_t holds the address in network byte order
+                    x = display_fb_draw_fixed(x, 52, (int32_t)((ip_info.ip.addr >> (8 * i)) & 0xFF), 0);
+                    if (i < 3) {
+                        x = display_fb_draw_string(x, 52, ".");
+                    }
+                }
             }
         }
     } else {
         // Not connected
-        snprintf(line, sizeof(line), "WiFi: Disconnected");
-        ssd1306_draw_string(ssd1306_dev, 0, 16, (uint8_t *)line, 12, 1);
-        
-        snprintf(line, sizeof(line), "Connecting...");
-        ssd1306_draw_string(ssd1306_dev, 0, 28, (uint8_t *)line, 12, 1);
+        display_fb_draw_label(0, 16, &labels[LABEL_WIFI_DISCONNECTED]);
+        display_fb_draw_label(0, 28, &labels[LABEL_CONNECTING]);
     }
 }
 
@@ -231,7 +447,7 @@ esp_err_t ssd1306_manager_set_screen(screen_id_t screen)
     current_screen = screen;
     ESP_LOGI(TAG, "Switched to screen %d", screen);
     
-    return ESP_OK;
+    return request_frame(DISPLAY_NOTIFY_SCREEN);
 }
 
 screen_id_t ssd1306_manager_get_screen(void)
@@ -239,37 +455,90 @@ screen_id_t ssd1306_manager_get_screen(void)
     return current_screen;
 }
 
+/**
+ * @brief Trend page next to from in direction step, series without samples (absent sensors) are skipped
+ *
+ * @return Series, HISTORY_SERIES_COUNT past the last page, going back ends on the DS18B20 page
+ */
+static history_series_t step_trend_series(int from, int step)
+{
+    for (int series = from + step; series > HISTORY_DS18B20_TEMP && series < HISTORY_SERIES_COUNT; series += step) {
+        if (sample_history_has_samples(series)) {
+            return series;
+        }
+    }
+    return step < 0 ? HISTORY_DS18B20_TEMP : HISTORY_SERIES_COUNT;
+}
+
 esp_err_t ssd1306_manager_next_screen(void)
 {
-    current_screen = (current_screen + 1) % SCREEN_COUNT;
+    // Looked up before the lock, the history has a lock of its own
+    history_series_t next_series = step_trend_series(trend_series, 1);
+
+    taskENTER_CRITICAL(&cache_lock);
+    // The trend screen has one page per sensor
+    if (current_screen == SCREEN_TREND && next_series < HISTORY_SERIES_COUNT) {
+        trend_series = next_series;
+    } else {
+        current_screen = (current_screen + 1) % SCREEN_COUNT;
+        trend_series = HISTORY_DS18B20_TEMP;
+    }
+    taskEXIT_CRITICAL(&cache_lock);
+
     ESP_LOGI(TAG, "Next screen: %d", current_screen);
-    return ESP_OK;
+    return request_frame(DISPLAY_NOTIFY_SCREEN);
 }
 
 esp_err_t ssd1306_manager_prev_screen(void)
 {
-    current_screen = (current_screen - 1 + SCREEN_COUNT) % SCREEN_COUNT;
+    history_series_t prev_series = step_trend_series(trend_series, -1);
+    history_series_t last_series = step_trend_series(HISTORY_SERIES_COUNT, -1);
+
+    taskENTER_CRITICAL(&cache_lock);
+    if (current_screen == SCREEN_TREND && trend_series > HISTORY_DS18B20_TEMP) {
+        trend_series = prev_series;
+    } else {
+        current_screen = (current_screen - 1 + SCREEN_COUNT) % SCREEN_COUNT;
+        trend_series = last_series;
+    }
+    taskEXIT_CRITICAL(&cache_lock);
+
     ESP_LOGI(TAG, "Previous screen: %d", current_screen);
-    return ESP_OK;
+    return request_frame(DISPLAY_NOTIFY_SCREEN);
 }
 
-esp_err_t ssd1306_manager_update_display()
+/**
+ * @brief Draw a frame and send the changed parts to the panel
+ *
+ * Only called from the display task, which owns the framebuffer and the panel.
+ */
+static esp_err_t render_frame(bool blank)
 {
-    if (!initialized || ssd1306_dev == NULL) {
-        return ESP_ERR_INVALID_STATE;
-    }
-    
-    // Clear screen
-    ssd1306_clear_screen(ssd1306_dev, 0x00);
+    display_values_t values;
+    screen_id_t screen;
+    history_series_t series;
+    taskENTER_CRITICAL(&cache_lock);
+    values = cached_values;
+    screen = blank ? SCREEN_COUNT : current_screen;
+    series = trend_series;
+    taskEXIT_CRITICAL(&cache_lock);
+
+    // Redraw into the framebuffer, only changed spans reach the panel
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    display_fb_clear();
     
     // Draw current screen
-    switch (current_screen) {
+    switch (screen) {
         case SCREEN_TEMPERATURES:
-            draw_screen_temperatures();
+            draw_screen_temperatures(&values);
             break;
             
         case SCREEN_ADC:
-            draw_screen_adc();
+            draw_screen_adc(&values);
+            break;
+            
+        case SCREEN_TREND:
+            trend_plot_draw(series);
             break;
             
         case SCREEN_SYSTEM:
@@ -281,12 +550,17 @@ esp_err_t ssd1306_manager_update_display()
             break;
             
         default:
-            ESP_LOGE(TAG, "Unknown screen: %d", current_screen);
             break;
     }
+
+    if (screen < SCREEN_COUNT) {
+        uint32_t cycles = (uint32_t)(esp_cpu_get_cycle_count() - start);
+        refresh_stats.render_cycles[screen] = cycles;
+        ESP_LOGD(TAG, "Screen %d rendered in %" PRIu32 " cycles", screen, cycles);
+    }
     
     // Refresh display
-    esp_err_t ret = ssd1306_refresh_gram(ssd1306_dev);
+    esp_err_t ret = flush_framebuffer();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to refresh display: %s", esp_err_to_name(ret));
         return ret;
@@ -294,3 +568,141 @@ esp_err_t ssd1306_manager_update_display()
     
     return ESP_OK;
 }
+
+/**
+ * @brief Switch the panel on or off, GRAM content is kept while off
+ */
+static esp_err_t set_panel_power(bool on)
+{
+    const uint8_t *cmd = on ? ssd1306_display_on_cmd : ssd1306_display_off_cmd;
+    esp_err_t ret = i2c_master_transmit(ssd1306_dev, cmd, sizeof(ssd1306_display_on_cmd), I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to switch display %s: %s", on ? "on" : "off", esp_err_to_name(ret));
+        return ret;
+    }
+
+    display_asleep = !on;
+    ESP_LOGI(TAG, "Display %s", on ? "woken up" : "off after inactivity");
+    return ESP_OK;
+}
+
+/**
+ * @brief Display task, owns the panel and renders on request
+ *
+ * Requests arriving while a frame is drawn or within the frame interval
+ * are merged, so a burst of updates results in a single frame. Without
+ * user activity for CONFIG_DISPLAY_SLEEP_TIMEOUT_S the panel is switched
+ * off and data updates are dropped until the next wake request.
+ */
+static void display_task(void *arg)
+{
+    const TickType_t frame_interval = pdMS_TO_TICKS(DISPLAY_FRAME_INTERVAL_MS);
+    TickType_t last_frame = xTaskGetTickCount() - frame_interval;
+    TickType_t last_activity = xTaskGetTickCount();
+
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (!display_asleep && DISPLAY_SLEEP_TICKS > 0) {
+            TickType_t idle = xTaskGetTickCount() - last_activity;
+            wait = idle < DISPLAY_SLEEP_TICKS ? DISPLAY_SLEEP_TICKS - idle : 0;
+        }
+
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &bits, wait) != pdTRUE) {
+            if (set_panel_power(false) != ESP_OK) {
+                // Try again after another timeout instead of retrying in a loop
+                last_activity = xTaskGetTickCount();
+            }
+            continue;
+        }
+
+        if (bits & (DISPLAY_NOTIFY_WAKE | DISPLAY_NOTIFY_SCREEN)) {
+            last_activity = xTaskGetTickCount();
+            if (display_asleep) {
+                // Redraw right away, GRAM still holds the frame from before sleep
+                render_frame(false);
+                set_panel_power(true);
+                last_frame = xTaskGetTickCount();
+                continue;
+            }
+        }
+
+        if (display_asleep) {
+            continue;
+        }
+
+        // Hold the frame back until the interval has passed, collecting further requests
+        TickType_t elapsed = xTaskGetTickCount() - last_frame;
+        if (!(bits & DISPLAY_NOTIFY_FULL) && elapsed < frame_interval) {
+            vTaskDelay(frame_interval - elapsed);
+        }
+
+        uint32_t more = 0;
+        if (xTaskNotifyWait(0, UINT32_MAX, &more, 0) == pdTRUE) {
+            bits |= more;
+        }
+
+        // Every full-frame request up to this one is served by the frame drawn below
+        uint32_t full_frame_seq = full_frame_requested;
+        if (bits & DISPLAY_NOTIFY_FULL) {
+            display_fb_invalidate();
+        }
+        esp_err_t ret = render_frame(bits & DISPLAY_NOTIFY_CLEAR);
+        last_frame = xTaskGetTickCount();
+
+        if (bits & DISPLAY_NOTIFY_FULL) {
+            if (ret == ESP_OK) {
+                ret = i2c_master_bus_wait_all_done(i2c_bus_manager_get_bus(), I2C_MASTER_TIMEOUT_MS);
+            }
+            if (ret == ESP_OK && !transfer_failed) {
+                xQueueOverwrite(full_frame_done, &full_frame_seq);
+            }
+        }
+    }
+}
+
+bool ssd1306_manager_wake(void)
+{
+    bool was_asleep = display_asleep;
+    request_frame(DISPLAY_NOTIFY_WAKE);
+    return was_asleep;
+}
+
+esp_err_t ssd1306_manager_flush_full(uint32_t timeout_ms)
+{
+    if (!initialized || display_asleep) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t seq = full_frame_requested + 1;
+    full_frame_requested = seq;
+    esp_err_t ret = request_frame(DISPLAY_NOTIFY_FULL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Completions of earlier requests that timed out may still arrive, skip them
+    const TickType_t start = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    TickType_t waited = 0;
+    uint32_t done = 0;
+    while (xQueueReceive(full_frame_done, &done, timeout - waited) == pdTRUE) {
+        if ((int32_t)(done - seq) >= 0) {
+            return ESP_OK;
+        }
+        waited = xTaskGetTickCount() - start;
+        if (waited >= timeout) {
+            break;
+        }
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t ssd1306_manager_update_display()
+{
+    // Nothing to draw while the panel is off
+    if (display_asleep) {
+        return ESP_OK;
+    }
+    return request_frame(DISPLAY_NOTIFY_DATA);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -12,15 +14,31 @@ extern "C" {
 typedef enum {
     SCREEN_TEMPERATURES = 0,  // DS18B20 + DHT22 temperatures
     SCREEN_ADC,               // ADC voltage measurement
+    SCREEN_TREND,             // Last hour of one sensor, buttons select the sensor
     SCREEN_SYSTEM,            // System info (memory, etc)
     SCREEN_NETWORK,           // Network info (WiFi, IP)
     SCREEN_COUNT              // Total number of screens
 } screen_id_t;
 
+/**
+ * @brief I2C traffic and render cost of display refreshes
+ *
+ * Counts bytes sent to the panel (control, command and GRAM bytes,
+ * without the I2C address byte). A full frame is 8 pages of 128 bytes
+ * plus window setup.
+ */
+typedef struct {
+    uint32_t refreshes;     // Number of refreshes
+    uint32_t last_bytes;    // Bytes sent by the last refresh
+    uint64_t total_bytes;   // Bytes sent by all refreshes
+    uint32_t render_cycles[SCREEN_COUNT];   // CPU cycles of the last draw of each screen (without I2C)
+} display_refresh_stats_t;
+
 /**
  * @brief Initialize the SSD1306 OLED display
  * 
- * This function initializes the I2C bus and SSD1306 display
+ * This function initializes the I2C bus and SSD1306 display and starts
+ * the display task, the only task that accesses the panel afterwards
  * 
  * @return ESP_OK on success, error code otherwise
  */
@@ -43,6 +61,9 @@ screen_id_t ssd1306_manager_get_screen(void);
 
 /**
  * @brief Switch to next screen
+ *
+ * On SCREEN_TREND switches to the next sensor first, the last sensor
+ * continues with the next screen.
  * 
  * @return ESP_OK on success, error code otherwise
  */
@@ -50,16 +71,70 @@ esp_err_t ssd1306_manager_next_screen(void);
 
 /**
  * @brief Switch to previous screen
+ *
+ * On SCREEN_TREND switches to the previous sensor first.
  * 
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t ssd1306_manager_prev_screen(void);
 
-void set_temp_values(float ds_temp, float dht_temp, float dht_humidity);
+/**
+ * @brief Update cached sensor values shown on the temperature screen
+ *
+ * @param ds_temp      DS18B20 temperature in 0.01 °C
+ * @param dht_temp     DHT22 temperature in 0.01 °C
+ * @param dht_humidity DHT22 humidity in 0.1 %RH
+ */
+void set_temp_values(int32_t ds_temp, int32_t dht_temp, int32_t dht_humidity);
 void set_voltage_value(int voltage);
+
+/**
+ * @brief Report user activity, switching the panel back on if it is off
+ *
+ * Restarts the inactivity timer. A panel that was off is redrawn
+ * immediately.
+ *
+ * @return true if the panel was off, the caller should not treat the
+ *         event as a regular input then
+ */
+bool ssd1306_manager_wake(void);
+
+/**
+ * @brief Request a redraw of the current screen
+ *
+ * Only notifies the display task and returns immediately. Requests
+ * arriving faster than CONFIG_DISPLAY_MAX_FPS are merged into one frame.
+ * Ignored while the panel is off.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the display is not initialized
+ */
 esp_err_t ssd1306_manager_update_display();
+
+/**
+ * @brief Redraw the current screen, send the full frame and wait until it is transferred
+ *
+ * The frame is drawn by the display task without waiting for the frame
+ * interval, the caller blocks until the last GRAM byte left the bus. Used
+ * to measure the full-frame I2C flush on the device.
+ *
+ * @param timeout_ms Maximum wait for the transfer
+ * @return ESP_OK when the frame is out,
+ *         ESP_ERR_INVALID_STATE if the display is not initialized or off,
+ *         ESP_ERR_TIMEOUT if the transfer failed or did not finish in time
+ */
+esp_err_t ssd1306_manager_flush_full(uint32_t timeout_ms);
+
+/**
+ * @brief Get I2C traffic counters of display refreshes
+ *
+ * @param out Destination of the counters
+ */
+void ssd1306_manager_get_refresh_stats(display_refresh_stats_t *out);
+
 /**
  * @brief Clear the OLED display
+ *
+ * The panel stays blank until the next update request.
  * 
  * @return ESP_OK on success, error code otherwise
  */
@@ -8,8 +8,11 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
+#include <stdlib.h>
 #include "esp_wifi.h"
 #include "esp_heap_caps.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
 #include "system.h"
 
 
@@ -56,6 +59,165 @@ void check_free_ram()
 #endif
 }
 
+void system_get_device_id(char *out, size_t len)
+{
+    uint8_t mac[6] = {0};
+
+    if (esp_read_mac(mac, ESP_MAC_WIFI_STA) != ESP_OK) {
+        ESP_LOGW("system", "Failed to read MAC address");
+    }
+    snprintf(out, len, "%02X%02X%02X%02X%02X%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+// Run-time counters of the previous sample, matched by task number
+#define METRICS_HISTORY_SIZE 32
+
+static struct {
+    uint32_t total;
+    size_t count;
+    UBaseType_t numbers[METRICS_HISTORY_SIZE];
+    uint32_t counters[METRICS_HISTORY_SIZE];
+} runtime_history;
+
+static system_metrics_callback_t metrics_callback = NULL;
+static uint32_t metrics_period_ms = 0;
+static TaskHandle_t metrics_task_handle = NULL;
+
+static void read_heap(uint32_t caps, heap_metrics_t *heap)
+{
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, caps);
+    heap->free = (uint32_t)info.total_free_bytes;
+    heap->min_free = (uint32_t)info.minimum_free_bytes;
+    heap->largest = (uint32_t)info.largest_free_block;
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+static uint32_t previous_counter(UBaseType_t number)
+{
+    for (size_t i = 0; i < runtime_history.count; i++) {
+        if (runtime_history.numbers[i] == number) {
+            return runtime_history.counters[i];
+        }
+    }
+    return 0;   // New task, its whole run time counts
+}
+
+static esp_err_t read_tasks(system_metrics_t *metrics)
+{
+    // Room for tasks created while the list is allocated
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *status = malloc(capacity * sizeof(TaskStatus_t));
+    if (status == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, capacity, &total);
+
+    // Task counters add up to the elapsed time once per core
+    uint32_t elapsed = ((uint32_t)total - runtime_history.total) * portNUM_PROCESSORS;
+    size_t history_count = 0;
+
+    metrics->total_tasks = count;
+    metrics->task_count = 0;
+    for (UBaseType_t i = 0; i < count; i++) {
+        uint32_t counter = (uint32_t)status[i].ulRunTimeCounter;
+
+        if (metrics->task_count < SYSTEM_METRICS_MAX_TASKS) {
+            task_metrics_t *task = &metrics->tasks[metrics->task_count++];
+            uint32_t busy = counter - previous_counter(status[i].xTaskNumber);
+
+            snprintf(task->name, sizeof(task->name), "%s", status[i].pcTaskName);
+            task->cpu_permille = elapsed ? (uint16_t)((uint64_t)busy * 1000 / elapsed) : 0;
+            // Stack is counted in bytes on ESP-IDF
+            task->stack_free = (uint32_t)status[i].usStackHighWaterMark;
+        }
+        if (history_count < METRICS_HISTORY_SIZE) {
+            runtime_history.numbers[history_count] = status[i].xTaskNumber;
+            runtime_history.counters[history_count] = counter;
+            history_count++;
+        }
+    }
+    runtime_history.count = history_count;
+    runtime_history.total = (uint32_t)total;
+
+    free(status);
+    return ESP_OK;
+}
+#else
+static esp_err_t read_tasks(system_metrics_t *metrics)
+{
+    metrics->total_tasks = uxTaskGetNumberOfTasks();
+    metrics->task_count = 0;
+    return ESP_OK;
+}
+#endif
+
+esp_err_t system_metrics_collect(system_metrics_t *metrics)
+{
+    metrics->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+
+    wifi_ap_record_t ap_info;
+    metrics->rssi = esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK ? ap_info.rssi : 0;
+
+    read_heap(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, &metrics->heap_internal);
+    read_heap(MALLOC_CAP_DMA, &metrics->heap_dma);
+#if CONFIG_SPIRAM
+    metrics->has_spiram = true;
+    read_heap(MALLOC_CAP_SPIRAM, &metrics->heap_spiram);
+#else
+    metrics->has_spiram = false;
+#endif
+
+    return read_tasks(metrics);
+}
+
+static void metrics_task(void *arg)
+{
+    // Static, the snapshot is too large for the task stack
+    static system_metrics_t metrics;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    // Baseline of the run-time counters, the first report covers one period
+    system_metrics_collect(&metrics);
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(metrics_period_ms));
+
+        if (system_metrics_collect(&metrics) == ESP_OK) {
+            metrics_callback(&metrics);
+        } else {
+            ESP_LOGW("system.metrics", "Failed to collect metrics");
+        }
+    }
+}
+
+esp_err_t system_metrics_start(uint32_t period_ms, system_metrics_callback_t callback)
+{
+    if (period_ms == 0 || callback == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (metrics_task_handle != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    metrics_period_ms = period_ms;
+    metrics_callback = callback;
+
+#if !(CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+    ESP_LOGW("system.metrics", "FreeRTOS run-time stats disabled, task metrics not available");
+#endif
+
+    if (xTaskCreate(metrics_task, "sys_metrics", 4096, NULL, 1, &metrics_task_handle) != pdPASS) {
+        ESP_LOGE("system.metrics", "Failed to create metrics task");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI("system.metrics", "Publishing metrics every %lu ms", (unsigned long)period_ms);
+    return ESP_OK;
+}
+
 void print_ip_info(void)
 {
     esp_netif_ip_info_t ip_info;
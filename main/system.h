@@ -2,7 +2,9 @@
 #define SYSTEM_H
 
 #include <stddef.h>
-
+#include <stdint.h>
+#include "esp_err.h"
+#include "messages/system_metrics.h"
 
 void check_psram(void);
 
@@ -10,4 +12,40 @@ void check_wifi_rssi(void);
 
 void check_free_ram(void);
 
+/**
+ * @brief Get unique device id (station MAC address as 12 uppercase hex digits).
+ *
+ * @param out Output buffer, at least 13 bytes.
+ * @param len Size of the output buffer.
+ */
+void system_get_device_id(char *out, size_t len);
+
+/**
+ * @brief Receives a metrics snapshot, called from the metrics task.
+ */
+typedef void (*system_metrics_callback_t)(const system_metrics_t *metrics);
+
+/**
+ * @brief Sample task, heap and Wi-Fi metrics.
+ *
+ * CPU shares cover the time since the previous call and need
+ * CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS,
+ * without them no tasks are reported. Not thread safe, the metrics task is
+ * the only caller once started.
+ *
+ * @param metrics Receives the snapshot.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the task list could not be allocated.
+ */
+esp_err_t system_metrics_collect(system_metrics_t *metrics);
+
+/**
+ * @brief Start a low priority task sampling metrics periodically.
+ *
+ * @param period_ms Sampling period.
+ * @param callback Receives every snapshot, e.g. to publish it.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a zero period or no callback,
+ *         ESP_ERR_INVALID_STATE if already started, ESP_FAIL if the task could not be created.
+ */
+esp_err_t system_metrics_start(uint32_t period_ms, system_metrics_callback_t callback);
+
 #endif // SYSTEM_H
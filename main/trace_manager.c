@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "mbedtls/base64.h"
+#include "trace_manager.h"
+
+static const char *TAG = "trace_manager";
+
+#if CONFIG_TRACE_ENABLE
+
+#define TRACE_RING_RECORDS CONFIG_TRACE_RING_RECORDS
+
+// Records per dump line, 512 bytes encode to 684 base64 characters, below the MQTT buffer size
+#define TRACE_DUMP_CHUNK_RECORDS 32
+#define TRACE_DUMP_HEADER_SIZE   48
+#define TRACE_DUMP_LINE_SIZE     (TRACE_DUMP_HEADER_SIZE + ((TRACE_DUMP_CHUNK_RECORDS * sizeof(trace_record_t) + 2) / 3) * 4 + 1)
+
+static trace_record_t ring[TRACE_RING_RECORDS];
+static uint32_t written = 0;        // Records written since boot
+static uint32_t lost = 0;           // Records dropped while a dump was running
+static bool frozen = false;
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void IRAM_ATTR trace_manager_record(trace_event_t event, uint32_t arg0, uint32_t arg1)
+{
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    portENTER_CRITICAL_SAFE(&trace_lock);
+    if (frozen) {
+        lost++;
+    } else {
+        trace_record_t *record = &ring[written % TRACE_RING_RECORDS];
+        record->time_us = now;
+        record->event = (uint16_t)event;
+        record->core = (uint8_t)esp_cpu_get_core_id();
+        record->reserved = 0;
+        record->arg0 = arg0;
+        record->arg1 = arg1;
+        written++;
+    }
+    portEXIT_CRITICAL_SAFE(&trace_lock);
+}
+
+esp_err_t trace_manager_dump(trace_output_t output, void *ctx)
+{
+    uint8_t *raw = malloc(TRACE_DUMP_CHUNK_RECORDS * sizeof(trace_record_t));
+    char *line = malloc(TRACE_DUMP_LINE_SIZE);
+    if (raw == NULL || line == NULL) {
+        free(raw);
+        free(line);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // The ring is not modified while frozen, no copy needed
+    portENTER_CRITICAL(&trace_lock);
+    frozen = true;
+    uint32_t total = written;
+    uint32_t lost_before = lost;
+    portEXIT_CRITICAL(&trace_lock);
+
+    uint32_t count = total < TRACE_RING_RECORDS ? total : TRACE_RING_RECORDS;
+    uint32_t overwritten = total - count;
+    uint32_t first = total - count;
+    uint32_t chunks = (count + TRACE_DUMP_CHUNK_RECORDS - 1) / TRACE_DUMP_CHUNK_RECORDS;
+    if (chunks == 0) {
+        chunks = 1;     // Header only, tells an empty ring from a failed dump
+    }
+
+    for (uint32_t chunk = 0; chunk < chunks; chunk++) {
+        uint32_t start = chunk * TRACE_DUMP_CHUNK_RECORDS;
+        uint32_t n = count - start < TRACE_DUMP_CHUNK_RECORDS ? count - start : TRACE_DUMP_CHUNK_RECORDS;
+
+        for (uint32_t i = 0; i < n; i++) {
+            memcpy(raw + i * sizeof(trace_record_t), &ring[(first + start + i) % TRACE_RING_RECORDS],
+                   sizeof(trace_record_t));
+        }
+
+        int len = snprintf(line, TRACE_DUMP_HEADER_SIZE, "TRC1 %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32 " ",
+                           chunk, chunks, overwritten, lost_before);
+        size_t encoded = 0;
+        mbedtls_base64_encode((unsigned char *)line + len, TRACE_DUMP_LINE_SIZE - (size_t)len, &encoded,
+                              raw, n * sizeof(trace_record_t));
+        line[len + encoded] = '\0';
+        output(line, ctx);
+    }
+
+    portENTER_CRITICAL(&trace_lock);
+    frozen = false;
+    uint32_t lost_during = lost - lost_before;
+    portEXIT_CRITICAL(&trace_lock);
+
+    ESP_LOGI(TAG, "Dumped %" PRIu32 " records in %" PRIu32 " lines, %" PRIu32 " events lost during the dump",
+             count, chunks, lost_during);
+
+    free(raw);
+    free(line);
+    return ESP_OK;
+}
+
+#else
+
+void trace_manager_record(trace_event_t event, uint32_t arg0, uint32_t arg1)
+{
+}
+
+esp_err_t trace_manager_dump(trace_output_t output, void *ctx)
+{
+    ESP_LOGW(TAG, "Tracing disabled (CONFIG_TRACE_ENABLE)");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+static void print_line(const char *line, void *ctx)
+{
+    printf("%s\n", line);
+}
+
+void trace_manager_print(void)
+{
+    trace_manager_dump(print_line, NULL);
+    fflush(stdout);
+}
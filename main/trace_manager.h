@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace event ids
+ *
+ * Values are part of the dump format, tools/trace_decode.py reads the
+ * names from this enum. Append new events, never renumber.
+ */
+typedef enum {
+    TRACE_EVENT_NONE = 0,
+    TRACE_EVENT_SAMPLE_START = 1,       // arg0 = sample source
+    TRACE_EVENT_SAMPLE_END = 2,         // arg0 = sample source
+    TRACE_EVENT_SAMPLE_VALUE = 3,       // arg0 = sample source, arg1 = value (0.01 °C or mV)
+    TRACE_EVENT_DHT22_READ_START = 4,
+    TRACE_EVENT_DHT22_READ_DONE = 5,    // arg0 = temperature (0.1 °C), arg1 = humidity (0.1 %RH)
+    TRACE_EVENT_MQTT_PUBLISH = 6,       // arg0 = payload length, arg1 = msg id (0 buffered, -1 error)
+    TRACE_EVENT_MQTT_PUBLISHED = 7,     // arg0 = msg id
+    TRACE_EVENT_MQTT_DATA = 8,          // arg0 = chunk length, arg1 = total length
+    TRACE_EVENT_BUTTON_EDGE = 9,        // arg0 = button index, recorded in the ISR
+} trace_event_t;
+
+/**
+ * @brief Trace record as stored in the ring and dumped, 16 bytes little endian
+ */
+typedef struct {
+    uint32_t time_us;       // Low 32 bits of esp_timer_get_time()
+    uint16_t event;         // trace_event_t
+    uint8_t core;           // CPU core that recorded the event
+    uint8_t reserved;
+    uint32_t arg0;
+    uint32_t arg1;
+} trace_record_t;
+
+/**
+ * @brief Receives one dump line, NUL-terminated without line break
+ */
+typedef void (*trace_output_t)(const char *line, void *ctx);
+
+/**
+ * @brief Record an event
+ *
+ * Copies the record into the RAM ring without any formatting, the oldest
+ * record is overwritten when the ring is full. Safe from tasks and ISRs.
+ * Use the TRACE() macro, which compiles to nothing without CONFIG_TRACE_ENABLE.
+ *
+ * @param event Event id
+ * @param arg0  First argument
+ * @param arg1  Second argument
+ */
+void trace_manager_record(trace_event_t event, uint32_t arg0, uint32_t arg1);
+
+#if CONFIG_TRACE_ENABLE
+#define TRACE(event, arg0, arg1) trace_manager_record((event), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define TRACE(event, arg0, arg1) ((void)0)
+#endif
+
+/**
+ * @brief Dump the ring as text lines
+ *
+ * Recording is paused for the dump, events recorded meanwhile are counted
+ * as lost. Each line is
+ *
+ *     TRC1 <chunk> <chunks> <overwritten> <lost> <base64 records>
+ *
+ * with the records oldest first. tools/trace_decode.py decodes the lines,
+ * also when they are embedded in a serial log.
+ *
+ * @param output Receives the lines
+ * @param ctx    Passed to output
+ * @return ESP_OK on success,
+ *         ESP_ERR_NO_MEM if the line buffer could not be allocated,
+ *         ESP_ERR_NOT_SUPPORTED without CONFIG_TRACE_ENABLE
+ */
+esp_err_t trace_manager_dump(trace_output_t output, void *ctx);
+
+/**
+ * @brief Dump the ring to the console (stdout)
+ */
+void trace_manager_print(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,156 @@
+#include <string.h>
+#include "display_framebuffer.h"
+#include "messages/fixed_point.h"
+#include "trend_plot.h"
+
+#define PLOT_FIRST_PAGE     2                       // Below the 12 px title line
+#define PLOT_PAGES          (DISPLAY_FB_PAGES - PLOT_FIRST_PAGE)
+#define PLOT_ROWS           (PLOT_PAGES * 8)
+#define PLOT_OPEN_X         (HISTORY_BUCKETS + 2)   // Open bucket, after a one column gap
+
+// Smallest vertical range per series so noise does not fill the plot
+static const int32_t min_span[HISTORY_SERIES_COUNT] = {
+    [HISTORY_DS18B20_TEMP] = 100,       // 1 °C
+    [HISTORY_DHT22_TEMP] = 100,         // 1 °C
+    [HISTORY_DHT22_HUMIDITY] = 50,      // 5 %RH
+    [HISTORY_VOLTAGE] = 100,            // 100 mV
+    [HISTORY_SHT3X_TEMP] = 100,         // 1 °C
+    [HISTORY_SHT3X_HUMIDITY] = 50,      // 5 %RH
+    [HISTORY_BME280_TEMP] = 100,        // 1 °C
+    [HISTORY_BME280_HUMIDITY] = 50,     // 5 %RH
+};
+
+// Decimals of the series values and of the value shown in the title
+static const int8_t value_decimals[HISTORY_SERIES_COUNT] = { 2, 2, 1, 3, 2, 1, 2, 1 };
+static const int8_t shown_decimals[HISTORY_SERIES_COUNT] = { 1, 1, 1, 2, 1, 1, 1, 1 };
+
+// Plot state, kept between frames (display task only)
+static history_bucket_t buckets[HISTORY_BUCKETS];
+static uint64_t columns[HISTORY_BUCKETS];          // Oldest bucket first
+static history_series_t plot_series = HISTORY_SERIES_COUNT;
+static uint32_t plot_generation;
+static int32_t scale_lo;
+static int32_t scale_hi;
+
+static bool bucket_empty(const history_bucket_t *bucket)
+{
+    return bucket->min > bucket->max;
+}
+
+static bool bucket_in_scale(const history_bucket_t *bucket)
+{
+    return bucket_empty(bucket) || (bucket->min >= scale_lo && bucket->max <= scale_hi);
+}
+
+static uint8_t value_row(int32_t value)
+{
+    if (value < scale_lo) {
+        value = scale_lo;
+    } else if (value > scale_hi) {
+        value = scale_hi;
+    }
+    return (uint8_t)((scale_hi - value) * (PLOT_ROWS - 1) / (scale_hi - scale_lo));
+}
+
+static uint64_t render_column(const history_bucket_t *bucket)
+{
+    if (bucket_empty(bucket)) {
+        return 0;
+    }
+
+    uint8_t top = value_row(bucket->max);
+    uint8_t bottom = value_row(bucket->min);
+    uint64_t bits = 0;
+
+    // Dotted min/max band with a solid average pixel
+    for (uint8_t row = top; row <= bottom; row++) {
+        if ((row & 1) == 0) {
+            bits |= 1ull << row;
+        }
+    }
+    bits |= 1ull << value_row(bucket->avg);
+    return bits;
+}
+
+/**
+ * @brief Fit the vertical scale to all buckets plus 1/8 margin on both sides
+ */
+static void rescale(history_series_t series, size_t count, const history_bucket_t *open)
+{
+    int32_t lo = INT32_MAX;
+    int32_t hi = INT32_MIN;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!bucket_empty(&buckets[i])) {
+            lo = buckets[i].min < lo ? buckets[i].min : lo;
+            hi = buckets[i].max > hi ? buckets[i].max : hi;
+        }
+    }
+    if (open) {
+        lo = open->min < lo ? open->min : lo;
+        hi = open->max > hi ? open->max : hi;
+    }
+    if (lo > hi) {
+        lo = 0;
+        hi = 0;
+    }
+
+    int32_t span = hi - lo;
+    if (span < min_span[series]) {
+        lo -= (min_span[series] - span) / 2;
+        span = min_span[series];
+    }
+    scale_lo = lo - span / 8;
+    scale_hi = lo + span + span / 8;
+}
+
+void trend_plot_draw(history_series_t series)
+{
+    if (series >= HISTORY_SERIES_COUNT) {
+        return;
+    }
+
+    uint32_t generation;
+    size_t count = sample_history_read(series, buckets, HISTORY_BUCKETS, &generation);
+    history_bucket_t open_bucket;
+    bool has_open = sample_history_get_open(series, &open_bucket);
+
+    uint32_t delta = generation - plot_generation;
+    bool full = series != plot_series || delta >= HISTORY_BUCKETS;
+    for (uint32_t age = 0; !full && age < delta && age < count; age++) {
+        full = !bucket_in_scale(&buckets[age]);
+    }
+    if (has_open && !bucket_in_scale(&open_bucket)) {
+        full = true;
+    }
+
+    if (full) {
+        rescale(series, count, has_open ? &open_bucket : NULL);
+        for (size_t age = 0; age < HISTORY_BUCKETS; age++) {
+            columns[HISTORY_BUCKETS - 1 - age] = age < count ? render_column(&buckets[age]) : 0;
+        }
+        plot_series = series;
+    } else if (delta > 0) {
+        // Shift the plot by the number of new buckets, render only those
+        memmove(columns, &columns[delta], (HISTORY_BUCKETS - delta) * sizeof(columns[0]));
+        for (size_t age = 0; age < delta; age++) {
+            columns[HISTORY_BUCKETS - 1 - age] = age < count ? render_column(&buckets[age]) : 0;
+        }
+    }
+    plot_generation = generation;
+
+    for (uint8_t x = 0; x < HISTORY_BUCKETS; x++) {
+        display_fb_draw_column(x, PLOT_FIRST_PAGE, PLOT_PAGES, columns[x]);
+    }
+    if (has_open) {
+        display_fb_draw_column(PLOT_OPEN_X, PLOT_FIRST_PAGE, PLOT_PAGES, render_column(&open_bucket));
+    }
+
+    // Title: series name and average of the open bucket
+    uint8_t x = display_fb_draw_string(0, 0, sample_history_series_name(series));
+    if (has_open) {
+        x = display_fb_draw_string(x, 0, " ");
+        display_fb_draw_fixed(x, 0, fixed_rescale(open_bucket.avg, value_decimals[series], shown_decimals[series]),
+                              shown_decimals[series]);
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "sample_history.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Draw the trend screen of a series into the framebuffer
+ *
+ * Plots one column per history bucket: a dotted band from min to max and
+ * a solid pixel at the average, newest bucket on the right and the open
+ * bucket after a gap. Plotted columns are kept between frames and only
+ * shifted by the number of newly closed buckets. A full re-plot happens
+ * when the series changes or a bucket leaves the current vertical scale.
+ *
+ * Must only be called from the display task.
+ *
+ * @param series Series to plot
+ */
+void trend_plot_draw(history_series_t series);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,12 +3,179 @@
 #include "esp_mac.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
+#include "nvs.h"
 #include <inttypes.h>
+#include <string.h>
 #include "sdkconfig.h"
 
 static const char *TAG = "wifi_manager";
 
+#define WIFI_NVS_NAMESPACE  "wifi"
+#define WIFI_NVS_KEY        "ap_cache"
+#define WIFI_CACHE_VERSION  1
+
+/**
+ * @brief Last good connection, used to skip the scan (and DHCP) on the next boot
+ */
+typedef struct {
+    uint8_t version;                // WIFI_CACHE_VERSION if valid
+    uint8_t channel;
+    uint8_t bssid[6];
+    esp_netif_ip_info_t lease;      // DHCP lease, zero if the address was static
+    esp_ip4_addr_t dns;
+} wifi_ap_cache_t;
+
+// Survives deep sleep, the lease is only reused from here as it may be stale after a power cycle
+static RTC_DATA_ATTR wifi_ap_cache_t rtc_cache;
+
+static wifi_ap_cache_t cache;               // AP to connect to, from RTC memory or NVS
+static wifi_ap_cache_t connected_ap;        // AP of the current connection
+static esp_netif_t *sta_netif = NULL;
+static bool fast_connect = false;           // Connecting to the cached BSSID and channel
+static bool static_ip = false;              // DHCP client stopped, address configured
+static int64_t connect_start_us = 0;
+static uint32_t time_to_ip_ms = 0;
+
+/**
+ * @brief Load the cached AP, RTC memory first, NVS after a reset or power cycle.
+ */
+static void load_ap_cache(void) {
+    if (rtc_cache.version == WIFI_CACHE_VERSION) {
+        cache = rtc_cache;
+        return;
+    }
+
+    memset(&cache, 0, sizeof(cache));
+    nvs_handle_t handle;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+    size_t size = sizeof(cache);
+    if (nvs_get_blob(handle, WIFI_NVS_KEY, &cache, &size) != ESP_OK || size != sizeof(cache) ||
+        cache.version != WIFI_CACHE_VERSION) {
+        memset(&cache, 0, sizeof(cache));
+    }
+    nvs_close(handle);
+
+    // Lease is not reused after a power cycle
+    memset(&cache.lease, 0, sizeof(cache.lease));
+}
+
+/**
+ * @brief Store the current connection, NVS is only written when the AP changed.
+ */
+static void save_ap_cache(void) {
+    bool ap_changed = cache.version != WIFI_CACHE_VERSION || cache.channel != connected_ap.channel ||
+                      memcmp(cache.bssid, connected_ap.bssid, sizeof(cache.bssid)) != 0;
+
+    connected_ap.version = WIFI_CACHE_VERSION;
+    rtc_cache = connected_ap;
+    cache = connected_ap;
+    if (!ap_changed) {
+        return;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(WIFI_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(handle, WIFI_NVS_KEY, &connected_ap, sizeof(connected_ap));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to store AP cache: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Configure the station, either for the cached AP or for a full scan by SSID.
+ *
+ * @param use_cache true to connect straight to the cached BSSID on its channel.
+ */
+static esp_err_t set_sta_config(bool use_cache) {
+    wifi_config_t wifi_config = {
+        .sta = {
+            .ssid = CONFIG_WIFI_SSID,
+            .password = CONFIG_WIFI_PASS,
+            .scan_method = use_cache ? WIFI_FAST_SCAN : WIFI_ALL_CHANNEL_SCAN,
+            .sort_method = WIFI_CONNECT_AP_BY_SIGNAL,
+        },
+    };
+
+    if (use_cache) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, cache.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = cache.channel;
+    }
+    fast_connect = use_cache;
+
+    return esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+}
+
+/**
+ * @brief Stop DHCP and configure a fixed address.
+ */
+static void set_static_ip(const esp_netif_ip_info_t *ip_info, esp_ip4_addr_t dns) {
+    esp_err_t ret = esp_netif_dhcpc_stop(sta_netif);
+    if (ret == ESP_OK) {
+        ret = esp_netif_set_ip_info(sta_netif, ip_info);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set static IP, using DHCP: %s", esp_err_to_name(ret));
+        esp_netif_dhcpc_start(sta_netif);
+        return;
+    }
+
+    if (dns.addr != 0) {
+        esp_netif_dns_info_t dns_info = {
+            .ip.u_addr.ip4 = dns,
+            .ip.type = ESP_IPADDR_TYPE_V4,
+        };
+        esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns_info);
+    }
+    static_ip = true;
+}
+
+/**
+ * @brief Apply the configured IP mode: static, cached lease or DHCP.
+ */
+static void apply_ip_config(void) {
+#if CONFIG_WIFI_IP_STATIC
+    esp_netif_ip_info_t ip_info = {0};
+    esp_ip4_addr_t dns = {0};
+    esp_netif_str_to_ip4(CONFIG_WIFI_STATIC_IP_ADDR, &ip_info.ip);
+    esp_netif_str_to_ip4(CONFIG_WIFI_STATIC_IP_NETMASK, &ip_info.netmask);
+    esp_netif_str_to_ip4(CONFIG_WIFI_STATIC_IP_GATEWAY, &ip_info.gw);
+    esp_netif_str_to_ip4(CONFIG_WIFI_STATIC_IP_DNS, &dns);
+    set_static_ip(&ip_info, dns);
+#elif CONFIG_WIFI_IP_CACHED_LEASE
+    if (cache.lease.ip.addr != 0) {
+        set_static_ip(&cache.lease, cache.dns);
+    }
+#endif
+}
+
+/**
+ * @brief Give up on the cached AP (and lease), connect with a full scan and DHCP.
+ */
+static void fall_back_to_scan(void) {
+    ESP_LOGW(TAG, "Fast connect to cached AP failed, falling back to full scan");
+    rtc_cache.version = 0;
+    set_sta_config(false);
+
+#if !CONFIG_WIFI_IP_STATIC
+    if (static_ip) {
+        static_ip = false;
+        esp_netif_dhcpc_start(sta_netif);
+    }
+#endif
+}
+
 /**
  * @brief Connect to the configured WiFi network.
  *
@@ -52,17 +219,25 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
 
     switch (event_id) {
         case WIFI_EVENT_STA_START:
-            ESP_LOGI(TAG, "WiFi started, connecting to %s", CONFIG_WIFI_SSID);
+            ESP_LOGI(TAG, "WiFi started, connecting to %s%s", CONFIG_WIFI_SSID,
+                     fast_connect ? " (cached AP)" : "");
             wifi_connect();
             break;
         case WIFI_EVENT_STA_DISCONNECTED:
             ESP_LOGE(TAG, "WiFi disconnected, retrying connection to %s", CONFIG_WIFI_SSID);
+            if (fast_connect) {
+                fall_back_to_scan();
+            }
             wifi_connect();
             break;
-        case WIFI_EVENT_STA_CONNECTED:
-            ESP_LOGI(TAG, "WiFi connected to %s", CONFIG_WIFI_SSID);
+        case WIFI_EVENT_STA_CONNECTED: {
+            wifi_event_sta_connected_t *event = (wifi_event_sta_connected_t *)event_data;
+            memcpy(connected_ap.bssid, event->bssid, sizeof(connected_ap.bssid));
+            connected_ap.channel = event->channel;
+            ESP_LOGI(TAG, "WiFi connected to %s on channel %d", CONFIG_WIFI_SSID, event->channel);
             print_wifi_rssi();
             break;
+        }
         case WIFI_EVENT_STA_BSS_RSSI_LOW:
             ESP_LOGW(TAG, "WiFi RSSI low on %s", CONFIG_WIFI_SSID);
             print_wifi_rssi();
@@ -89,10 +264,29 @@ static void ip_event_handler(void* arg, esp_event_base_t event_base,
     }
 
     switch (event_id) {
-        case IP_EVENT_STA_GOT_IP:
+        case IP_EVENT_STA_GOT_IP: {
             ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-            ESP_LOGI(TAG, "WiFi got IP: " IPSTR, IP2STR(&event->ip_info.ip));
+            if (time_to_ip_ms == 0) {
+                time_to_ip_ms = (uint32_t)((esp_timer_get_time() - connect_start_us) / 1000);
+            }
+            ESP_LOGI(TAG, "WiFi got IP: " IPSTR " in %" PRIu32 " ms (%s, %s)", IP2STR(&event->ip_info.ip),
+                     time_to_ip_ms, fast_connect ? "cached AP" : "scan", static_ip ? "static" : "DHCP");
+
+            // Remember a new lease from DHCP, keep the reused one otherwise
+            if (!static_ip) {
+                esp_netif_dns_info_t dns_info;
+                connected_ap.lease = event->ip_info;
+                connected_ap.dns.addr = 0;
+                if (esp_netif_get_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns_info) == ESP_OK) {
+                    connected_ap.dns = dns_info.ip.u_addr.ip4;
+                }
+            } else {
+                connected_ap.lease = cache.lease;
+                connected_ap.dns = cache.dns;
+            }
+            save_ap_cache();
             break;
+        }
         case IP_EVENT_STA_LOST_IP:
             ESP_LOGE(TAG, "WiFi lost IP, reconnecting to %s", CONFIG_WIFI_SSID);
             wifi_connect();
@@ -110,6 +304,7 @@ static void ip_event_handler(void* arg, esp_event_base_t event_base,
  */
 esp_err_t wifi_init(void) {
     ESP_LOGI(TAG, "WiFi initialization started");
+    connect_start_us = esp_timer_get_time();
 
     // Initialize NVS
     esp_err_t ret = nvs_flash_init();
@@ -121,7 +316,7 @@ esp_err_t wifi_init(void) {
 
     // Initialize TCP/IP stack and event loop
     ESP_ERROR_CHECK(esp_netif_init());
-    esp_netif_create_default_wifi_sta();
+    sta_netif = esp_netif_create_default_wifi_sta();
 
     // Initialize WiFi driver
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
@@ -131,19 +326,19 @@ esp_err_t wifi_init(void) {
     ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &ip_event_handler, NULL));
 
-    // Configure WiFi connection
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = CONFIG_WIFI_SSID,
-            .password = CONFIG_WIFI_PASS,
-        },
-    };
+    // Connect straight to the last good AP when known, scan otherwise
+    load_ap_cache();
+    apply_ip_config();
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    ESP_ERROR_CHECK(set_sta_config(cache.version == WIFI_CACHE_VERSION));
     ESP_ERROR_CHECK(esp_wifi_start());
 
     ESP_LOGI(TAG, "WiFi initialization finished");
 
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+uint32_t wifi_manager_get_time_to_ip_ms(void) {
+    return time_to_ip_ms;
+}
@@ -1,13 +1,27 @@
 #ifndef WIFI_MANAGER_H
 #define WIFI_MANAGER_H
 
+#include <stdint.h>
 #include <esp_err.h>
 
 /**
  * @brief Initialize WiFi in station mode and connect to the configured network.
  *
+ * The BSSID and channel of the last good connection are cached in NVS and
+ * RTC memory and used to connect without a scan. The DHCP lease is reused
+ * after a deep sleep wake with CONFIG_WIFI_IP_CACHED_LEASE, a static
+ * address with CONFIG_WIFI_IP_STATIC. If the cached AP cannot be joined
+ * the manager falls back to a full scan and DHCP.
+ *
  * @return ESP_OK if WiFi initialized and started, error code otherwise.
  */
 esp_err_t wifi_init(void);
 
+/**
+ * @brief Get the time from wifi_init() to the first IP address.
+ *
+ * @return Time in milliseconds, 0 if no address was obtained yet.
+ */
+uint32_t wifi_manager_get_time_to_ip_ms(void);
+
 #endif // WIFI_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Compare two runs of the host microbenchmarks.
+
+Reads the JSON documents printed by host/bench, e.g. of the base and the
+head commit, and prints the change of every case. Log lines around the
+document are skipped, so the raw output of the run can be passed.
+
+    build/esp32-workshop-thermometer-bench.elf > head.json
+    tools/bench_compare.py base.json head.json --threshold 10
+
+Exits with 1 when a case got slower by more than the threshold or does
+more heap allocations per op than before.
+"""
+
+import argparse
+import json
+import sys
+
+SCHEMA = 1
+
+
+def load(path):
+    """Return the results of the first benchmark document in the file by case name."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    decoder = json.JSONDecoder()
+    for start in (i for i, c in enumerate(text) if c == "{"):
+        try:
+            doc, _ = decoder.raw_decode(text, start)
+        except ValueError:
+            continue
+        if isinstance(doc, dict) and "results" in doc:
+            if doc.get("schema") != SCHEMA:
+                raise SystemExit(f"{path}: schema {doc.get('schema')}, expected {SCHEMA}")
+            return {r["name"]: r for r in doc["results"]}
+    raise SystemExit(f"{path}: no benchmark results found")
+
+
+def change(base, head):
+    return (head - base) * 100.0 / base if base else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base", help="results of the reference run")
+    parser.add_argument("head", help="results of the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    parser.add_argument("--metric", choices=("ns_per_op", "ns_min"), default="ns_min",
+                        help="time compared, the minimum is the least noisy")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    head = load(args.head)
+
+    regressions = 0
+    print(f"{'case':<28} {'base ns':>10} {'head ns':>10} {'change':>8} {'allocs':>13} {'bytes':>13}")
+    for name, new in head.items():
+        old = base.get(name)
+        if old is None:
+            print(f"{name:<28} {'':>10} {new[args.metric]:10.1f} {'new':>8}")
+            continue
+
+        delta = change(old[args.metric], new[args.metric])
+        slower = delta > args.threshold
+        more_allocs = new["allocs_per_op"] > old["allocs_per_op"]
+        allocs = f"{old['allocs_per_op']:g}->{new['allocs_per_op']:g}"
+        size = f"{old['bytes_per_op']:g}->{new['bytes_per_op']:g}"
+        flag = " <<" if slower or more_allocs else ""
+        regressions += slower or more_allocs
+        print(f"{name:<28} {old[args.metric]:10.1f} {new[args.metric]:10.1f} {delta:+7.1f}% {allocs:>13} {size:>13}{flag}")
+
+    for name in base.keys() - head.keys():
+        print(f"{name:<28} {base[name][args.metric]:10.1f} {'':>10} {'removed':>8}")
+
+    if regressions:
+        print(f"{regressions} case(s) regressed beyond {args.threshold:g}%", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Decode trace ring dumps of the thermometer firmware.
+
+Reads "TRC1 ..." lines written by trace_manager_dump(), either captured
+from the trace MQTT topic or embedded in a serial log, and prints one
+line per record with the time relative to the first record.
+
+    mosquitto_sub -t 'test/devices/<id>/trace' -C <chunks> | tools/trace_decode.py
+    tools/trace_decode.py serial.log
+
+Event names are read from the trace_event_t enum in main/trace_manager.h.
+"""
+
+import argparse
+import base64
+import os
+import re
+import struct
+import sys
+
+RECORD = struct.Struct("<IHBBII")   # trace_record_t, little endian
+LINE_RE = re.compile(r"TRC1 (\d+) (\d+) (\d+) (\d+) ([A-Za-z0-9+/=]*)")
+EVENT_RE = re.compile(r"TRACE_EVENT_(\w+)\s*=\s*(\d+)")
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "main", "trace_manager.h")
+
+
+def load_event_names(header):
+    names = {}
+    try:
+        with open(header, encoding="utf-8") as f:
+            for match in EVENT_RE.finditer(f.read()):
+                names[int(match.group(2))] = match.group(1)
+    except OSError as err:
+        print(f"warning: no event names, {err}", file=sys.stderr)
+    return names
+
+
+def read_chunks(files):
+    """Collect the chunks of the last dump found in the input."""
+    chunks = {}
+    total = None
+    header = None
+    for f in files:
+        for line in f:
+            match = LINE_RE.search(line)
+            if not match:
+                continue
+            index, count, overwritten, lost, data = match.groups()
+            if int(index) == 0:
+                chunks = {}     # Start of a new dump
+            total = int(count)
+            header = (int(overwritten), int(lost))
+            chunks[int(index)] = base64.b64decode(data)
+    return chunks, total, header
+
+
+def decode(raw):
+    for offset in range(0, len(raw) - RECORD.size + 1, RECORD.size):
+        yield RECORD.unpack_from(raw, offset)
+
+
+def to_signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="*", help="dump or log files, stdin if none")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="trace_manager.h with the event ids")
+    args = parser.parse_args()
+
+    names = load_event_names(args.header)
+    files = [open(path, encoding="utf-8", errors="replace") for path in args.files] or [sys.stdin]
+    chunks, total, header = read_chunks(files)
+
+    if total is None:
+        print("no trace dump found", file=sys.stderr)
+        return 1
+    missing = [i for i in range(total) if i not in chunks]
+    if missing:
+        print(f"warning: chunks {missing} of {total} missing", file=sys.stderr)
+
+    overwritten, lost = header
+    print(f"# {overwritten} records overwritten before the dump, {lost} lost during dumps")
+    print(f"{'time ms':>12} {'delta us':>9} core event{'':<16} arg0 arg1")
+
+    raw = b"".join(chunks[i] for i in sorted(chunks))
+    start = None
+    previous = None
+    base = 0
+    for time_us, event, core, _, arg0, arg1 in decode(raw):
+        # Unwrap the 32-bit microsecond counter
+        if previous is not None and time_us + base < previous:
+            base += 1 << 32
+        now = time_us + base
+        if start is None:
+            start = now
+        delta = now - previous if previous is not None else 0
+        previous = now
+        name = names.get(event, f"EVENT_{event}")
+        print(f"{(now - start) / 1000:12.3f} {delta:9d} {core:4d} {name:<21} {to_signed(arg0)} {to_signed(arg1)}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())